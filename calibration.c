@@ -1,5 +1,7 @@
 #include "calibration.h"
 
+#define FLOOD_FILL_BENCHMARK_REPETITIONS 100
+
 /**
  * @brief Calibrate side sensors and gyroscope's Z axis.
  *
@@ -20,6 +22,9 @@ void calibrate(void)
  * decelerate back to zero speed. There is no angular speed in this test, only
  * linear movement. During all this test information about the relevant linear
  * speed variables is logged periodically for later analysis.
+ *
+ * The logged tracking error is useful to tune the motor feedforward: with a
+ * good motor model it should stay close to zero during the whole profile.
  */
 void run_linear_speed_profile(void)
 {
@@ -47,7 +52,8 @@ void run_linear_speed_profile(void)
  * The robot will accelerate, maintain the target speed for a while and then
  * decelerate back to zero speed. There is no linear speed in this test, only
  * rotational movement. During all this test information about the relevant
- * angular speed variables is logged periodically for later analysis.
+ * angular speed variables is logged periodically for later analysis,
+ * including the angular tracking error.
  *
  * The target turn is 3 * PI radians.
  */
@@ -161,6 +167,7 @@ void run_movement_sequence(const char *sequence)
 		default:
 			break;
 		}
+		wait_next_cell();
 	}
 	reset_motion();
 }
@@ -198,3 +205,37 @@ void run_front_sensors_calibration(void)
 
 	repeat_blink(10, 100);
 }
+
+/**
+ * @brief Compare the cycle count of the available flood-fill engines.
+ *
+ * Each engine floods the current maze memory towards the classic goal a
+ * number of times. The average number of CPU cycles per flood is logged for
+ * each engine, to decide which one to select with `SEARCH_FLOOD_ENGINE`.
+ */
+void run_flood_fill_benchmark(void)
+{
+	int i;
+	uint32_t start;
+	uint32_t queue_cycles;
+	uint32_t bitboard_cycles;
+
+	set_target_goal();
+
+	start = read_cycle_counter();
+	for (i = 0; i < FLOOD_FILL_BENCHMARK_REPETITIONS; i++)
+		set_distances_queue();
+	queue_cycles = (read_cycle_counter() - start) /
+		       FLOOD_FILL_BENCHMARK_REPETITIONS;
+
+	start = read_cycle_counter();
+	for (i = 0; i < FLOOD_FILL_BENCHMARK_REPETITIONS; i++)
+		set_distances_bitboard();
+	bitboard_cycles = (read_cycle_counter() - start) /
+			  FLOOD_FILL_BENCHMARK_REPETITIONS;
+
+	set_distances();
+	LOG_INFO("{\"queue_cycles\":%" PRIu32 ",\"bitboard_cycles\":%" PRIu32
+		 "}",
+		 queue_cycles, bitboard_cycles);
+}
@@ -7,6 +7,7 @@
 #include "mmlib/control.h"
 #include "mmlib/logging.h"
 #include "mmlib/mpu.h"
+#include "mmlib/search.h"
 #include "mmlib/speed.h"
 #include "mmlib/walls.h"
 
@@ -20,5 +21,6 @@ void run_distances_profiling(void);
 void run_movement_sequence(const char *sequence);
 void run_static_turn_right_profile(void);
 void run_front_sensors_calibration(void);
+void run_flood_fill_benchmark(void);
 
 #endif /* __CALIBRATION_H */
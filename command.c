@@ -1,5 +1,26 @@
 #include "command.h"
 
+/**
+ * @brief Generate the parameters of a turn from a received command.
+ *
+ * The command is `set turn <turn_type> <radius> <transition>`, where the turn
+ * type is the `enum movement` value of the turn.
+ *
+ * @param[in] string String buffer containing the command.
+ */
+static void set_turn(char *string)
+{
+	enum movement turn_type;
+	float radius;
+	float transition;
+
+	turn_type = (enum movement)parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+	radius = parse_float(string, RECEIVE_BUFFER_SIZE, 3);
+	transition = parse_float(string, RECEIVE_BUFFER_SIZE, 4);
+	if (!generate_turn(turn_type, radius, transition))
+		LOG_ERROR("Unfeasible turn: `%s`!", string);
+}
+
 /**
  * @brief Process a command received.
  *
@@ -22,6 +43,8 @@ static void process_command(char *string)
 		run_static_turn_right_profile();
 	else if (!strcmp(string, "run front_sensors_calibration"))
 		run_front_sensors_calibration();
+	else if (!strcmp(string, "run flood_fill_benchmark"))
+		run_flood_fill_benchmark();
 	else if (starts_with(string, "move "))
 		run_movement_sequence(string);
 	else if (starts_with(string, "set micrometers_per_count "))
@@ -33,6 +56,8 @@ static void process_command(char *string)
 	else if (starts_with(string, "set linear_speed_limit "))
 		set_linear_speed_limit(
 		    parse_float(string, RECEIVE_BUFFER_SIZE, 2));
+	else if (starts_with(string, "set turn "))
+		set_turn(string);
 	else if (starts_with(string, "set kp_linear ")) {
 		control.kp_linear = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
 		set_control_constants(control);
@@ -63,6 +88,24 @@ static void process_command(char *string)
 		control.kp_angular_front =
 		    parse_float(string, RECEIVE_BUFFER_SIZE, 2);
 		set_control_constants(control);
+	} else if (starts_with(string, "set kv_left ")) {
+		control.kv_left = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
+	} else if (starts_with(string, "set kv_right ")) {
+		control.kv_right = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
+	} else if (starts_with(string, "set ka_left ")) {
+		control.ka_left = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
+	} else if (starts_with(string, "set ka_right ")) {
+		control.ka_right = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
+	} else if (starts_with(string, "set ks_left ")) {
+		control.ks_left = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
+	} else if (starts_with(string, "set ks_right ")) {
+		control.ks_right = parse_float(string, RECEIVE_BUFFER_SIZE, 2);
+		set_control_constants(control);
 	} else
 		LOG_ERROR("Unknown command: `%s`!", string);
 }
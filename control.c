@@ -2,7 +2,10 @@
 
 static volatile float target_linear_speed;
 static volatile float ideal_linear_speed;
+static volatile float ideal_linear_acceleration;
 static volatile float ideal_angular_speed;
+static volatile float last_ideal_linear_speed;
+static volatile float last_ideal_angular_speed;
 
 static volatile float linear_error;
 static volatile float angular_error;
@@ -39,6 +42,31 @@ static int32_t voltage_to_motor_pwm(float voltage)
 	return voltage / get_motor_driver_input_voltage() * DRIVER_PWM_PERIOD;
 }
 
+/**
+ * @brief Voltage required by a motor to follow a wheel speed profile.
+ *
+ * The motor model is `kv * speed + ka * acceleration + ks * sign(speed)`,
+ * where the last term compensates for static friction.
+ *
+ * @param[in] kv Voltage per unit of wheel speed, in volts per meter/second.
+ * @param[in] ka Voltage per unit of wheel acceleration, in volts per
+ * meter/second^2.
+ * @param[in] ks Voltage required to overcome static friction, in volts.
+ * @param[in] speed Ideal wheel speed, in meters per second.
+ * @param[in] acceleration Ideal wheel acceleration, in meters per second^2.
+ */
+static float motor_feedforward(float kv, float ka, float ks, float speed,
+			       float acceleration)
+{
+	float voltage = kv * speed + ka * acceleration;
+
+	if (speed > 0.)
+		voltage += ks;
+	else if (speed < 0.)
+		voltage -= ks;
+	return voltage;
+}
+
 /**
  * @brief Enable or disable the side sensors close control.
  */
@@ -133,7 +161,10 @@ void reset_control_speed(void)
 {
 	target_linear_speed = 0.;
 	ideal_linear_speed = 0.;
+	ideal_linear_acceleration = 0.;
 	ideal_angular_speed = 0.;
+	last_ideal_linear_speed = 0.;
+	last_ideal_angular_speed = 0.;
 }
 
 /**
@@ -238,6 +269,14 @@ float get_ideal_linear_speed(void)
 	return ideal_linear_speed;
 }
 
+/**
+ * @brief Return the current ideal linear acceleration in meters per second^2.
+ */
+float get_ideal_linear_acceleration(void)
+{
+	return ideal_linear_acceleration;
+}
+
 /**
  * @brief Return the current ideal angular speed in radians per second.
  */
@@ -262,6 +301,28 @@ float get_measured_angular_speed(void)
 	return -get_gyro_z_radps();
 }
 
+/**
+ * @brief Return the current linear tracking error in meters.
+ *
+ * This is the accumulated difference between the ideal and the measured
+ * linear speed, positive when the robot lags behind the ideal profile.
+ */
+float get_linear_tracking_error(void)
+{
+	return linear_error / SYSTICK_FREQUENCY_HZ;
+}
+
+/**
+ * @brief Return the current angular tracking error in radians.
+ *
+ * This is the accumulated difference between the ideal and the measured
+ * angular speed, positive when the robot lags behind the ideal profile.
+ */
+float get_angular_tracking_error(void)
+{
+	return angular_error / SYSTICK_FREQUENCY_HZ;
+}
+
 /**
  * @brief Set target linear speed in meters per second.
  */
@@ -281,21 +342,35 @@ void set_ideal_angular_speed(float speed)
 /**
  * @brief Update ideal linear speed according to the defined speed profile.
  *
- * Current ideal speed is increased or decreased according to the target speed
- * and the defined maximum acceleration and deceleration.
+ * The profile is an S-curve: the ideal acceleration changes at the maximum
+ * jerk towards the maximum acceleration or deceleration, and starts ramping
+ * back down to zero just in time to reach the target speed with no
+ * acceleration.
  */
 void update_ideal_linear_speed(void)
 {
-	if (ideal_linear_speed < target_linear_speed) {
-		ideal_linear_speed +=
-		    get_linear_acceleration() / SYSTICK_FREQUENCY_HZ;
-		if (ideal_linear_speed > target_linear_speed)
-			ideal_linear_speed = target_linear_speed;
-	} else if (ideal_linear_speed > target_linear_speed) {
-		ideal_linear_speed -=
-		    get_linear_deceleration() / SYSTICK_FREQUENCY_HZ;
-		if (ideal_linear_speed < target_linear_speed)
-			ideal_linear_speed = target_linear_speed;
+	float jerk = get_linear_jerk();
+	float jerk_step = jerk / SYSTICK_FREQUENCY_HZ;
+	float error = target_linear_speed - ideal_linear_speed;
+	float settling;
+
+	if (error == 0. && ideal_linear_acceleration == 0.)
+		return;
+	settling = ideal_linear_acceleration *
+		   fabsf(ideal_linear_acceleration) / (2 * jerk);
+	if (error > settling)
+		ideal_linear_acceleration =
+		    fminf(ideal_linear_acceleration + jerk_step,
+			  get_linear_acceleration());
+	else
+		ideal_linear_acceleration =
+		    fmaxf(ideal_linear_acceleration - jerk_step,
+			  -get_linear_deceleration());
+	ideal_linear_speed +=
+	    ideal_linear_acceleration / SYSTICK_FREQUENCY_HZ;
+	if (error * (target_linear_speed - ideal_linear_speed) <= 0.) {
+		ideal_linear_speed = target_linear_speed;
+		ideal_linear_acceleration = 0.;
 	}
 }
 
@@ -304,6 +379,10 @@ void update_ideal_linear_speed(void)
  *
  * Set the motors power to try to follow a defined speed profile.
  *
+ * The feedback voltages are added to a feedforward, which is the voltage that
+ * the motor model requires for each wheel to follow the ideal speeds and
+ * accelerations.
+ *
  * This function also implements collision detection by checking PWM output
  * saturation. If collision is detected it sets the `collision_detected_signal`
  * variable to `true`.
@@ -315,6 +394,11 @@ void motor_control(void)
 	float side_sensors_feedback = 0.;
 	float front_sensors_feedback = 0.;
 	float diagonal_sensors_feedback = 0.;
+	float linear_acceleration;
+	float angular_acceleration;
+	float half_separation;
+	float feedforward_left;
+	float feedforward_right;
 	struct control_constants control;
 
 	if (!motor_control_enabled_signal)
@@ -359,6 +443,23 @@ void motor_control(void)
 	    control.ki_angular_front * front_sensors_integral +
 	    control.ki_angular_diagonal * diagonal_sensors_integral;
 
+	linear_acceleration = (ideal_linear_speed - last_ideal_linear_speed) *
+			      SYSTICK_FREQUENCY_HZ;
+	angular_acceleration =
+	    (ideal_angular_speed - last_ideal_angular_speed) *
+	    SYSTICK_FREQUENCY_HZ;
+	half_separation = get_wheels_separation() / 2.;
+	feedforward_left = motor_feedforward(
+	    control.kv_left, control.ka_left, control.ks_left,
+	    ideal_linear_speed + ideal_angular_speed * half_separation,
+	    linear_acceleration + angular_acceleration * half_separation);
+	feedforward_right = motor_feedforward(
+	    control.kv_right, control.ka_right, control.ks_right,
+	    ideal_linear_speed - ideal_angular_speed * half_separation,
+	    linear_acceleration - angular_acceleration * half_separation);
+	linear_voltage += (feedforward_left + feedforward_right) / 2.;
+	angular_voltage += (feedforward_left - feedforward_right) / 2.;
+
 	voltage_left = linear_voltage + angular_voltage;
 	voltage_right = linear_voltage - angular_voltage;
 	pwm_left = voltage_to_motor_pwm(voltage_left);
@@ -369,6 +470,8 @@ void motor_control(void)
 
 	last_linear_error = linear_error;
 	last_angular_error = angular_error;
+	last_ideal_linear_speed = ideal_linear_speed;
+	last_ideal_angular_speed = ideal_angular_speed;
 
 	if (motor_driver_saturation() >
 	    MAX_MOTOR_DRIVER_SATURATION_PERIOD * SYSTICK_FREQUENCY_HZ)
@@ -30,9 +30,12 @@ int32_t get_left_pwm(void);
 int32_t get_right_pwm(void);
 float get_target_linear_speed(void);
 float get_ideal_linear_speed(void);
+float get_ideal_linear_acceleration(void);
 float get_ideal_angular_speed(void);
 float get_measured_linear_speed(void);
 float get_measured_angular_speed(void);
+float get_linear_tracking_error(void);
+float get_angular_tracking_error(void);
 void motor_control(void);
 void set_target_linear_speed(float speed);
 void set_ideal_angular_speed(float speed);
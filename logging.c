@@ -55,6 +55,9 @@ void log_battery_voltage(void)
 
 /**
  * @brief Log all the configuration variables.
+ *
+ * The motor feedforward constants are logged in a separate line, so that each
+ * message fits in the log buffer.
  */
 void log_configuration_variables(void)
 {
@@ -76,6 +79,14 @@ void log_configuration_variables(void)
 		 control.kd_linear, control.kp_angular, control.kd_angular,
 		 control.ki_angular_side, control.ki_angular_front,
 		 control.kp_angular_side, control.kp_angular_front);
+	LOG_INFO("{\"kv_left\":%f,"
+		 "\"kv_right\":%f,"
+		 "\"ka_left\":%f,"
+		 "\"ka_right\":%f,"
+		 "\"ks_left\":%f,"
+		 "\"ks_right\":%f}",
+		 control.kv_left, control.kv_right, control.ka_left,
+		 control.ka_right, control.ks_left, control.ks_right);
 }
 
 /**
@@ -87,6 +98,7 @@ void log_configuration_variables(void)
  * - Actual speed of both wheels (left and right).
  * - Motor driver output voltage for both motors.
  * - PWM output value for both motors.
+ * - Linear tracking error, in meters.
  */
 void log_linear_speed(void)
 {
@@ -98,10 +110,11 @@ void log_linear_speed(void)
 	float voltage_right = get_right_motor_voltage();
 	int pwm_left = get_left_pwm();
 	int pwm_right = get_right_pwm();
+	float tracking_error = get_linear_tracking_error();
 
-	LOG_INFO("%f,%f,%f,%f,%f,%f,%d,%d", target_speed, ideal_speed,
+	LOG_INFO("%f,%f,%f,%f,%f,%f,%d,%d,%f", target_speed, ideal_speed,
 		 left_speed, right_speed, voltage_left, voltage_right, pwm_left,
-		 pwm_right);
+		 pwm_right, tracking_error);
 }
 
 /**
@@ -113,6 +126,7 @@ void log_linear_speed(void)
  * - Actual calculated angular speed.
  * - Motor driver output voltage for both motors.
  * - PWM output value for both motors.
+ * - Angular tracking error, in radians.
  */
 void log_angular_speed(void)
 {
@@ -122,9 +136,24 @@ void log_angular_speed(void)
 	float voltage_right = get_right_motor_voltage();
 	int pwm_left = get_left_pwm();
 	int pwm_right = get_right_pwm();
+	float tracking_error = get_angular_tracking_error();
+
+	LOG_INFO("%f,%f,%f,%f,%d,%d,%f", ideal_speed, angular_speed,
+		 voltage_left, voltage_right, pwm_left, pwm_right,
+		 tracking_error);
+}
+
+/**
+ * @brief Log the estimated pose.
+ *
+ * Position (X and Y), heading, linear speed and angular speed.
+ */
+void log_odometry_pose(void)
+{
+	struct pose pose = get_odometry_pose();
 
-	LOG_INFO("%f,%f,%f,%f,%d,%d", ideal_speed, angular_speed, voltage_left,
-		 voltage_right, pwm_left, pwm_right);
+	LOG_INFO("%f,%f,%f,%f,%f", pose.x, pose.y, pose.heading,
+		 pose.linear_speed, pose.angular_speed);
 }
 
 /**
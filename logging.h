@@ -10,6 +10,7 @@
 #include "mmlib/control.h"
 #include "mmlib/encoder.h"
 #include "mmlib/mpu.h"
+#include "mmlib/odometry.h"
 #include "mmlib/speed.h"
 #include "mmlib/walls.h"
 #include "printf/printf.h"
@@ -96,6 +97,7 @@ void log_battery_voltage(void);
 void log_configuration_variables(void);
 void log_linear_speed(void);
 void log_angular_speed(void);
+void log_odometry_pose(void);
 void log_sensors_distance(void);
 void log_encoders_counts(void);
 void log_sensors_raw(void);
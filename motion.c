@@ -0,0 +1,277 @@
+#include "motion.h"
+
+/**
+ * Motion module static variables.
+ *
+ * - Circular queue of pending motions. Motions are only added by the main
+ *   loop and only removed from the SYSTICK.
+ * - Number of motions queued and completed (or discarded) so far.
+ * - Whether the motion at the head of the queue has already started.
+ * - Starting point of the current motion, in micrometers or ticks.
+ * - Target and diagonal control points of the current motion, in micrometers.
+ * - Whether the current motion is already braking to its end speed.
+ */
+static struct motion queue[MOTION_QUEUE_SIZE];
+static volatile uint8_t queue_head;
+static volatile uint8_t queue_tail;
+static uint32_t queued_motions;
+static volatile uint32_t completed_motions;
+static volatile bool motion_started;
+static int32_t motion_start;
+static int32_t motion_target;
+static int32_t motion_control_target;
+static bool motion_braking;
+
+/**
+ * @brief Add a motion to the queue.
+ *
+ * If the queue is full, wait until a motion is completed.
+ *
+ * @param[in] motion Motion to execute.
+ */
+void enqueue_motion(struct motion motion)
+{
+	uint8_t next = (queue_tail + 1) % MOTION_QUEUE_SIZE;
+
+	while (next == queue_head)
+		;
+	queue[queue_tail] = motion;
+	/* The motion must be stored before the SYSTICK can see it queued */
+	__asm__ volatile("" ::: "memory");
+	queue_tail = next;
+	queued_motions++;
+}
+
+/**
+ * @brief Return the number of motions queued so far.
+ *
+ * It identifies the last queued motion, to wait for it to be completed with
+ * `wait_motion_completed()`.
+ */
+uint32_t get_queued_motions(void)
+{
+	return queued_motions;
+}
+
+/**
+ * @brief Add a straight motion to the queue.
+ *
+ * @param[in] start Starting point, in micrometers.
+ * @param[in] distance Distance to travel, in meters, from the starting point.
+ * @param[in] speed Target speed, in meters per second.
+ * @param[in] controls Walls control to enable when the motion starts.
+ */
+void enqueue_straight(int32_t start, float distance, float speed,
+		      uint8_t controls)
+{
+	struct motion motion = {
+	    .type = MOTION_STRAIGHT,
+	    .controls = controls,
+	    .start = start,
+	    .distance = distance,
+	    .end_speed = speed,
+	};
+
+	enqueue_motion(motion);
+}
+
+/**
+ * @brief Add a diagonal motion to the queue.
+ *
+ * The motion starts wherever the previous motion ended, with walls control
+ * disabled.
+ *
+ * @param[in] distance Distance to travel, in meters.
+ * @param[in] control_distance Distance with diagonal control, in meters.
+ * @param[in] speed Target speed, in meters per second.
+ */
+void enqueue_diagonal(float distance, float control_distance, float speed)
+{
+	struct motion motion = {
+	    .type = MOTION_DIAGONAL,
+	    .controls = 0,
+	    .start = MOTION_CURRENT_POSITION,
+	    .distance = distance,
+	    .control_distance = control_distance,
+	    .end_speed = speed,
+	};
+
+	enqueue_motion(motion);
+}
+
+/**
+ * @brief Return whether all queued motions have been completed.
+ */
+bool motion_queue_empty(void)
+{
+	return queue_head == queue_tail;
+}
+
+/**
+ * @brief Wait until all queued motions have been completed.
+ */
+void wait_motion_queue_empty(void)
+{
+	while (!motion_queue_empty())
+		;
+}
+
+/**
+ * @brief Wait until a queued motion has been completed or discarded.
+ *
+ * @param[in] motion Motion identifier, see `get_queued_motions()`.
+ */
+void wait_motion_completed(uint32_t motion)
+{
+	while ((int32_t)(motion - completed_motions) > 0)
+		;
+}
+
+/**
+ * @brief Set the walls control and the starting point of a motion.
+ */
+static void start_motion(struct motion *motion)
+{
+	int32_t start;
+
+	if (!(motion->controls & MOTION_CONTROL_KEEP)) {
+		side_sensors_close_control(motion->controls &
+					   MOTION_CONTROL_SIDE_CLOSE);
+		side_sensors_far_control(motion->controls &
+					 MOTION_CONTROL_SIDE_FAR);
+		front_sensors_control(motion->controls & MOTION_CONTROL_FRONT);
+	}
+	switch (motion->type) {
+	case MOTION_STRAIGHT:
+	case MOTION_DIAGONAL:
+		start = motion->start;
+		if (start == MOTION_CURRENT_POSITION)
+			start = get_encoder_average_micrometers();
+		motion_target =
+		    start + (int32_t)(motion->distance * MICROMETERS_PER_METER);
+		motion_control_target =
+		    start + (int32_t)(motion->control_distance *
+				      MICROMETERS_PER_METER);
+		motion_braking = false;
+		set_ideal_angular_speed(0.);
+		if (motion->type == MOTION_DIAGONAL)
+			diagonal_sensors_control(true);
+		break;
+	case MOTION_SPEED_TURN:
+		motion_start = get_encoder_average_micrometers();
+		break;
+	case MOTION_INPLACE_TURN:
+		motion_start = get_clock_ticks();
+		set_target_linear_speed(get_ideal_linear_speed());
+		break;
+	}
+}
+
+/**
+ * @brief Update the target linear speed of a straight or diagonal motion.
+ *
+ * @return Whether the motion has been completed.
+ */
+static bool advance_straight(struct motion *motion)
+{
+	int32_t limit;
+	int32_t position = get_encoder_average_micrometers();
+	bool forward = motion->distance > 0;
+
+	if (motion->type == MOTION_DIAGONAL && position > motion_control_target)
+		diagonal_sensors_control(false);
+	if (!motion_braking && (motion->controls & MOTION_CONTROL_FRONT_STOP) &&
+	    get_front_wall_distance() < CELL_DIMENSION)
+		motion_target = position +
+				(int32_t)((get_front_wall_distance() -
+					   motion->control_distance) *
+					  MICROMETERS_PER_METER);
+	if (!motion_braking) {
+		limit = motion_target -
+			required_micrometers_to_speed(motion->end_speed);
+		if (forward ? position < limit : position > limit) {
+			set_target_linear_speed(forward
+						    ? get_max_linear_speed()
+						    : -get_max_linear_speed());
+			return false;
+		}
+		motion_braking = true;
+		set_target_linear_speed(motion->end_speed);
+	}
+	if (motion->end_speed == 0.)
+		return get_ideal_linear_speed() == 0.;
+	return forward ? position >= motion_target : position <= motion_target;
+}
+
+/**
+ * @brief Update the ideal angular speed of a speed or in-place turn.
+ *
+ * The angular speed follows a sinusoidal transition, a constant phase and a
+ * sinusoidal transition back to zero.
+ *
+ * @return Whether the motion has been completed.
+ */
+static bool advance_turn(struct motion *motion)
+{
+	float progress;
+	float factor = 1.;
+
+	if (motion->type == MOTION_SPEED_TURN)
+		progress = (float)(get_encoder_average_micrometers() -
+				   motion_start) /
+			   MICROMETERS_PER_METER;
+	else
+		progress = (float)(get_clock_ticks() - motion_start) /
+			   SYSTICK_FREQUENCY_HZ;
+	if (progress >= 2 * motion->transition + motion->arc) {
+		set_ideal_angular_speed(0);
+		return true;
+	}
+	if (progress < motion->transition)
+		factor = sin(progress / motion->transition * PI / 2);
+	else if (progress >= motion->transition + motion->arc)
+		factor = sin((progress - motion->arc) / motion->transition *
+			     PI / 2);
+	set_ideal_angular_speed(motion->max_angular_velocity * factor);
+	return false;
+}
+
+/**
+ * @brief Advance the queued motions.
+ *
+ * This function is called from the SYSTICK periodically, right before
+ * `motor_control()`. Completed motions are removed from the queue and the
+ * next one is started right away. All pending motions are discarded if a
+ * collision is detected.
+ */
+void motion_tick(void)
+{
+	bool completed;
+	struct motion *motion;
+
+	if (collision_detected()) {
+		motion_started = false;
+		completed_motions += (queue_tail - queue_head +
+				      MOTION_QUEUE_SIZE) %
+				     MOTION_QUEUE_SIZE;
+		queue_head = queue_tail;
+		return;
+	}
+	while (queue_head != queue_tail) {
+		motion = &queue[queue_head];
+		if (!motion_started) {
+			start_motion(motion);
+			motion_started = true;
+		}
+		if (motion->type == MOTION_STRAIGHT ||
+		    motion->type == MOTION_DIAGONAL)
+			completed = advance_straight(motion);
+		else
+			completed = advance_turn(motion);
+		if (!completed)
+			break;
+		motion_started = false;
+		queue_head = (queue_head + 1) % MOTION_QUEUE_SIZE;
+		completed_motions++;
+	}
+}
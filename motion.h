@@ -0,0 +1,74 @@
+#ifndef __MOTION_H
+#define __MOTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mmlib/clock.h"
+#include "mmlib/control.h"
+#include "mmlib/move.h"
+
+#include "setup.h"
+
+#define MOTION_QUEUE_SIZE 16
+#define MOTION_CURRENT_POSITION INT32_MIN
+
+/**
+ * Walls control to enable when a motion starts.
+ *
+ * With `MOTION_CONTROL_KEEP` the walls control is left untouched. With
+ * `MOTION_CONTROL_FRONT_STOP` the target of a straight motion is corrected on
+ * the fly, while not braking yet, to end at the control distance from the
+ * front wall.
+ */
+#define MOTION_CONTROL_SIDE_CLOSE 1
+#define MOTION_CONTROL_SIDE_FAR 2
+#define MOTION_CONTROL_FRONT 4
+#define MOTION_CONTROL_KEEP 8
+#define MOTION_CONTROL_FRONT_STOP 16
+
+enum motion_type {
+	MOTION_STRAIGHT,     /**< Reach a distance at a given speed */
+	MOTION_DIAGONAL,     /**< Same as straight, with diagonal control */
+	MOTION_SPEED_TURN,   /**< Angular profile over the travelled distance */
+	MOTION_INPLACE_TURN, /**< Angular profile over time */
+};
+
+/**
+ * A motion primitive to be executed from the SYSTICK.
+ *
+ * - Motion type
+ * - Walls control to enable when the motion starts
+ * - Starting point, in micrometers, or `MOTION_CURRENT_POSITION` to start
+ *   wherever the previous motion ended
+ * - Distance to travel, in meters, from the starting point
+ * - Distance with diagonal control, in meters, from the starting point, or
+ *   distance to end from the front wall with `MOTION_CONTROL_FRONT_STOP`
+ * - Speed at which to end the motion, in meters per second
+ * - Maximum angular velocity of a turn, in radians per second
+ * - Duration of each transition phase of a turn, in meters or seconds
+ * - Duration of the constant angular velocity phase, in meters or seconds
+ */
+struct motion {
+	enum motion_type type;
+	uint8_t controls;
+	int32_t start;
+	float distance;
+	float control_distance;
+	float end_speed;
+	float max_angular_velocity;
+	float transition;
+	float arc;
+};
+
+void enqueue_motion(struct motion motion);
+void enqueue_straight(int32_t start, float distance, float speed,
+		      uint8_t controls);
+void enqueue_diagonal(float distance, float control_distance, float speed);
+uint32_t get_queued_motions(void);
+bool motion_queue_empty(void);
+void wait_motion_queue_empty(void);
+void wait_motion_completed(uint32_t motion);
+void motion_tick(void);
+
+#endif /* __MOTION_H */
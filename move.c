@@ -3,6 +3,9 @@
 static int32_t current_cell_start_micrometers;
 /* Angular acceleration is defined in radians per second squared. */
 static float angular_acceleration;
+/* Whether a queued move is entering the next cell, and its last motion */
+static bool next_cell_pending;
+static uint32_t next_cell_motion;
 
 /**
  * @brief Return the current robot shift inside the cell, in meters.
@@ -37,23 +40,70 @@ static void _entered_next_cell(void)
 	led_left_toggle();
 }
 
+/**
+ * @brief Wait until the robot enters the cell reached by the queued move.
+ *
+ * Moves into the next cell are queued without waiting for them, so that the
+ * next move can be planned and queued while the robot is moving. The new cell
+ * is marked when the last motion of the move is completed. This must be
+ * called before reading the walls of the new cell.
+ */
+void wait_next_cell(void)
+{
+	if (!next_cell_pending)
+		return;
+	next_cell_pending = false;
+	wait_motion_completed(next_cell_motion);
+	_entered_next_cell();
+}
+
+/**
+ * @brief Return the starting point of the first motion of a queued move.
+ *
+ * If the previous move is still being executed, the start of the cell is not
+ * known yet, so the move starts where the previous one ends.
+ */
+static int32_t _queued_cell_start(void)
+{
+	if (next_cell_pending)
+		return MOTION_CURRENT_POSITION;
+	return current_cell_start_micrometers;
+}
+
+/**
+ * @brief Mark a move into the next cell as queued.
+ *
+ * The robot is kept at most one move ahead: the previous move, if any, must
+ * be completed before returning.
+ */
+static void _queued_next_cell(void)
+{
+	wait_next_cell();
+	next_cell_pending = true;
+	next_cell_motion = get_queued_motions();
+}
+
 /**
  * @brief Initialize mouse position.
  *
- * Assumes the mouse tail is initially touching a wall.
+ * Assumes the mouse tail is initially touching a wall. The odometry pose is
+ * set in the start cell, heading north, with the origin at the south-west
+ * corner of the maze.
  */
 void set_starting_position(void)
 {
 	current_cell_start_micrometers =
 	    get_encoder_average_micrometers() -
 	    MOUSE_START_SHIFT * MICROMETERS_PER_METER;
+	set_odometry_pose(CELL_DIMENSION / 2, MOUSE_START_SHIFT, PI / 2);
 }
 
 /**
  * @brief Calculate the required micrometers to reach a given speed.
  *
- * This functions assumes the current speed is the target speed and takes into
- * account the configured linear deceleration.
+ * This functions follows the jerk-limited speed profile from the current
+ * ideal speed and acceleration: the current acceleration is ramped down to
+ * zero first, and then the speed changes to the target speed.
  *
  * @param[in] speed Target speed.
 
@@ -61,31 +111,26 @@ void set_starting_position(void)
  */
 int32_t required_micrometers_to_speed(float speed)
 {
-	float acceleration;
 	float current_speed = get_ideal_linear_speed();
+	float acceleration = get_ideal_linear_acceleration();
+	float ramp = fabsf(acceleration) / get_linear_jerk();
+	float distance;
 
-	acceleration = (current_speed > speed) ? -get_linear_deceleration()
-					       : get_linear_acceleration();
-
-	return (int32_t)((speed * speed - current_speed * current_speed) /
-			 (2 * acceleration) * MICROMETERS_PER_METER);
+	distance = ramp * (current_speed + acceleration * ramp / 3);
+	current_speed += acceleration * ramp / 2;
+	distance += get_speed_change_distance(current_speed, speed);
+	return (int32_t)(distance * MICROMETERS_PER_METER);
 }
 
 /**
  * @brief Calculate the required time to reach a given speed, in seconds.
  *
  * This functions assumes the current speed is the target speed and takes into
- * account the configured linear deceleration.
+ * account the configured linear acceleration, deceleration and jerk.
  */
 float required_time_to_speed(float speed)
 {
-	float acceleration;
-	float target_speed = get_target_linear_speed();
-
-	acceleration = (target_speed > speed) ? -get_linear_deceleration()
-					      : get_linear_acceleration();
-
-	return (speed - target_speed) / acceleration;
+	return get_speed_change_time(get_target_linear_speed(), speed);
 }
 
 /**
@@ -104,68 +149,16 @@ uint32_t required_ticks_to_speed(float speed)
 /**
  * @brief Reach a target position at a target speed.
  *
+ * Walls control is kept as it is when the motion starts.
+ *
  * @param[in] start Starting point, in micrometers.
  * @param[in] distance Distance to travel, in meters, from the starting point.
  * @param[in] speed Target speed, in meters per second.
  */
 void target_straight(int32_t start, float distance, float speed)
 {
-	int32_t target_distance;
-
-	set_ideal_angular_speed(0.);
-
-	target_distance = start + (int32_t)(distance * MICROMETERS_PER_METER);
-	if (distance > 0) {
-		set_target_linear_speed(get_max_linear_speed());
-		while (get_encoder_average_micrometers() <
-		       target_distance - required_micrometers_to_speed(speed))
-			;
-	} else {
-		set_target_linear_speed(-get_max_linear_speed());
-		while (get_encoder_average_micrometers() >
-		       target_distance - required_micrometers_to_speed(speed))
-			;
-	}
-	set_target_linear_speed(speed);
-	if (speed == 0.) {
-		while (get_ideal_linear_speed() != speed)
-			;
-	} else {
-		while (get_encoder_average_micrometers() < target_distance)
-			;
-	}
-}
-
-/**
- * @brief Reach a target position at a target speed on a diagonal.
- *
- * @param[in] start Starting point, in micrometers.
- * @param[in] distance Distance to travel, in meters, from the starting point.
- * @param[in] control_distance Distance with control, in meters, from the
- * starting point.
- * @param[in] speed Target speed, in meters per second.
- */
-static void target_straight_diagonal(int32_t start, float distance,
-				     float control_distance, float speed)
-{
-	int32_t target_distance, target_control_distance;
-
-	set_ideal_angular_speed(0.);
-	target_distance = start + (int32_t)(distance * MICROMETERS_PER_METER);
-	target_control_distance =
-	    start + (int32_t)(control_distance * MICROMETERS_PER_METER);
-	diagonal_sensors_control(true);
-	set_target_linear_speed(get_max_linear_speed());
-	while (get_encoder_average_micrometers() <
-	       target_distance - required_micrometers_to_speed(speed)) {
-		if (get_encoder_average_micrometers() > target_control_distance)
-			diagonal_sensors_control(false);
-	};
-	set_target_linear_speed(speed);
-	while (get_encoder_average_micrometers() < target_distance) {
-		if (get_encoder_average_micrometers() > target_control_distance)
-			diagonal_sensors_control(false);
-	};
+	enqueue_straight(start, distance, speed, MOTION_CONTROL_KEEP);
+	wait_motion_queue_empty();
 }
 
 /**
@@ -235,6 +228,7 @@ void keep_front_wall_distance(float distance)
  */
 void stop_end(void)
 {
+	wait_next_cell();
 	front_sensors_control(true);
 	side_sensors_close_control(true);
 	side_sensors_far_control(false);
@@ -251,6 +245,7 @@ void stop_head_front_wall(void)
 {
 	float distance = CELL_DIMENSION - WALL_WIDTH / 2. - MOUSE_HEAD;
 
+	wait_next_cell();
 	front_sensors_control(true);
 	side_sensors_close_control(true);
 	side_sensors_far_control(false);
@@ -266,6 +261,7 @@ void stop_middle(void)
 {
 	float distance = CELL_DIMENSION / 2.;
 
+	wait_next_cell();
 	front_sensors_control(true);
 	side_sensors_close_control(true);
 	side_sensors_far_control(false);
@@ -283,6 +279,7 @@ void turn_back(float force)
 {
 	int direction_sign;
 
+	wait_next_cell();
 	if (get_front_wall_distance() < CELL_DIMENSION)
 		keep_front_wall_distance(CELL_DIMENSION / 2.);
 	disable_walls_control();
@@ -320,15 +317,15 @@ void turn_to_start_position(float force)
 
 /**
  * @brief Move front into the next cell.
+ *
+ * The move is queued, see `wait_next_cell()`.
  */
 void move_front(void)
 {
-	front_sensors_control(true);
-	side_sensors_close_control(true);
-	side_sensors_far_control(false);
-	target_straight(current_cell_start_micrometers, CELL_DIMENSION,
-			get_max_linear_speed());
-	_entered_next_cell();
+	enqueue_straight(_queued_cell_start(), CELL_DIMENSION,
+			 get_max_linear_speed(),
+			 MOTION_CONTROL_SIDE_CLOSE | MOTION_CONTROL_FRONT);
+	_queued_next_cell();
 }
 
 /**
@@ -354,44 +351,30 @@ void parametric_move_front(float distance, float end_linear_speed)
 void parametric_move_diagonal(float distance, float control_distance,
 			      float end_linear_speed)
 {
-	target_straight_diagonal(get_encoder_average_micrometers(), distance,
-				 control_distance, end_linear_speed);
+	enqueue_diagonal(distance, control_distance, end_linear_speed);
+	wait_motion_queue_empty();
 }
 
 /**
  * @brief Move left or right into the next cell.
  *
+ * The move is queued, see `wait_next_cell()`.
+ *
  * @param[in] movement Turn direction (left or right).
  * @param[in] force Maximum force to apply on the tires.
  */
 void move_side(enum movement turn, float force)
 {
-	front_sensors_control(true);
-	side_sensors_close_control(true);
-	side_sensors_far_control(true);
-	target_straight(current_cell_start_micrometers,
-			get_move_turn_before(turn),
-			get_move_turn_linear_speed(turn, force));
-	disable_walls_control();
-	speed_turn(turn, force);
-	front_sensors_control(true);
-	side_sensors_close_control(true);
-	side_sensors_far_control(true);
-	target_straight(get_encoder_average_micrometers(),
-			get_move_turn_after(turn), get_max_linear_speed());
-	_entered_next_cell();
-}
-
-/**
- * @brief Move back into the previous cell.
- *
- * @param[in] force Maximum force to apply on the tires.
- */
-void move_back(float force)
-{
-	stop_middle();
-	turn_back(force);
-	move_front();
+	float speed = get_move_turn_linear_speed(turn, force);
+	uint8_t controls = MOTION_CONTROL_SIDE_CLOSE | MOTION_CONTROL_SIDE_FAR |
+			   MOTION_CONTROL_FRONT;
+
+	enqueue_straight(_queued_cell_start(), get_move_turn_before(turn),
+			 speed, controls);
+	enqueue_speed_turn(turn, speed);
+	enqueue_straight(MOTION_CURRENT_POSITION, get_move_turn_after(turn),
+			 get_max_linear_speed(), controls);
+	_queued_next_cell();
 }
 
 /**
@@ -415,98 +398,327 @@ void move(enum step_direction direction, float force)
 }
 
 /**
- * @brief Execute an in-place turn.
+ * @brief Calculate the angular speed profile of an in-place turn.
  *
- * @param[in] radians Radians to turn (positive means left).
+ * @param[in] radians Radians to turn (absolute value).
  * @param[in] force Maximum force to apply while turning.
+ * @param[out] max_angular_velocity Maximum angular velocity reached.
+ * @param[out] transition Duration, in seconds, of each transition phase.
+ * @param[out] arc Duration, in seconds, of the constant velocity phase.
  */
-void inplace_turn(float radians, float force)
+static void _inplace_turn_profile(float radians, float force,
+				  float *max_angular_velocity,
+				  float *transition, float *arc)
 {
-	int turn_sign;
-	int32_t start;
-	int32_t current;
-	float time;
-	float angular_velocity;
-	float max_angular_velocity;
-	float factor;
-	float arc;
-	float transition;
 	float duration;
 	float transition_angle;
 
-	turn_sign = sign(radians);
-	radians = fabsf(radians);
 	angular_acceleration =
 	    force * MOUSE_WHEELS_SEPARATION / MOUSE_MOMENT_OF_INERTIA;
-	max_angular_velocity = sqrt(radians / 2 * angular_acceleration);
-	if (max_angular_velocity > MOUSE_MAX_ANGULAR_VELOCITY)
-		max_angular_velocity = MOUSE_MAX_ANGULAR_VELOCITY;
+	*max_angular_velocity = sqrt(radians / 2 * angular_acceleration);
+	if (*max_angular_velocity > MOUSE_MAX_ANGULAR_VELOCITY)
+		*max_angular_velocity = MOUSE_MAX_ANGULAR_VELOCITY;
+
+	duration = *max_angular_velocity / angular_acceleration * PI;
+	transition_angle = duration * *max_angular_velocity / PI;
+	*arc = (radians - 2 * transition_angle) / *max_angular_velocity;
+	*transition = duration / 2;
+}
 
-	duration = max_angular_velocity / angular_acceleration * PI;
-	transition_angle = duration * max_angular_velocity / PI;
-	arc = (radians - 2 * transition_angle) / max_angular_velocity;
-	transition = duration / 2;
-	max_angular_velocity = turn_sign * max_angular_velocity;
+/**
+ * @brief Calculate the required time to execute an in-place turn, in seconds.
+ *
+ * @param[in] radians Radians to turn.
+ * @param[in] force Maximum force to apply while turning.
+ */
+float required_time_to_turn_in_place(float radians, float force)
+{
+	float max_angular_velocity;
+	float transition;
+	float arc;
 
-	set_target_linear_speed(get_ideal_linear_speed());
-	disable_walls_control();
-	start = get_clock_ticks();
-	while (true) {
-		current = get_clock_ticks();
-		time = (float)(current - start) / SYSTICK_FREQUENCY_HZ;
-		if (time >= 2 * transition + arc)
+	_inplace_turn_profile(fabsf(radians), force, &max_angular_velocity,
+			      &transition, &arc);
+	return 2 * transition + arc;
+}
+
+/**
+ * @brief Calculate the required time to move back into the previous cell.
+ *
+ * Estimation, in seconds, for `move_back()` at the current kinematic
+ * configuration. See `get_move_time()`.
+ *
+ * @param[in] force Maximum force to apply on the tires.
+ */
+float required_time_to_move_back(float force)
+{
+	return get_move_time(MOVE_BACK, force);
+}
+
+/**
+ * @brief Execute an in-place turn.
+ *
+ * @param[in] radians Radians to turn (positive means left).
+ * @param[in] force Maximum force to apply while turning.
+ */
+void inplace_turn(float radians, float force)
+{
+	struct motion motion = {
+	    .type = MOTION_INPLACE_TURN,
+	    .controls = 0,
+	};
+
+	_inplace_turn_profile(fabsf(radians), force,
+			      &motion.max_angular_velocity, &motion.transition,
+			      &motion.arc);
+	motion.max_angular_velocity *= sign(radians);
+	enqueue_motion(motion);
+	wait_motion_queue_empty();
+}
+
+/**
+ * @brief Move back into the previous cell.
+ *
+ * The robot takes a U-turn while moving, without stopping, and leaves the
+ * cell at search speed. The curve starts where it reaches the center of the
+ * cell, which is corrected on the fly with the front wall distance. The
+ * lateral displacement of the curve is absorbed by the side walls control on
+ * the way out. The move is queued, see `wait_next_cell()`.
+ *
+ * @param[in] force Maximum force to apply on the tires.
+ */
+void move_back(float force)
+{
+	float before = get_move_turn_before(MOVE_BACK);
+	float speed = fminf(get_move_turn_linear_speed(MOVE_BACK, force),
+			    get_max_linear_speed());
+	struct motion entry = {
+	    .type = MOTION_STRAIGHT,
+	    .controls = MOTION_CONTROL_SIDE_CLOSE | MOTION_CONTROL_FRONT |
+			MOTION_CONTROL_FRONT_STOP,
+	    .start = _queued_cell_start(),
+	    .distance = before,
+	    .control_distance = CELL_DIMENSION - before,
+	    .end_speed = speed,
+	};
+
+	enqueue_motion(entry);
+	enqueue_speed_turn(MOVE_BACK, speed);
+	enqueue_straight(MOTION_CURRENT_POSITION,
+			 get_move_turn_after(MOVE_BACK), get_max_linear_speed(),
+			 MOTION_CONTROL_SIDE_CLOSE);
+	_queued_next_cell();
+}
+
+/**
+ * @brief Return whether a smooth path movement is a speed turn.
+ */
+static bool _is_speed_turn(enum movement movement)
+{
+	switch (movement) {
+	case MOVE_LEFT:
+	case MOVE_RIGHT:
+	case MOVE_LEFT_90:
+	case MOVE_RIGHT_90:
+	case MOVE_LEFT_180:
+	case MOVE_RIGHT_180:
+	case MOVE_LEFT_90_LARGE:
+	case MOVE_RIGHT_90_LARGE:
+	case MOVE_LEFT_180_LARGE:
+	case MOVE_RIGHT_180_LARGE:
+	case MOVE_LEFT_TO_45:
+	case MOVE_RIGHT_TO_45:
+	case MOVE_LEFT_TO_135:
+	case MOVE_RIGHT_TO_135:
+	case MOVE_LEFT_FROM_45:
+	case MOVE_RIGHT_FROM_45:
+	case MOVE_LEFT_FROM_135:
+	case MOVE_RIGHT_FROM_135:
+	case MOVE_LEFT_DIAGONAL:
+	case MOVE_RIGHT_DIAGONAL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Get the straight distance available after a smooth path turn.
+ *
+ * It is the distance travelled until the next node of the path, including the
+ * straight distance that the next turn, in its tightest variant, adds before
+ * it.
+ *
+ * @param[in] smooth_path Sequence of smooth movements after the turn.
+ */
+static float _get_straight_after_turn(struct smooth_step *smooth_path)
+{
+	float distance = 0.;
+
+	for (; smooth_path->movement != MOVE_END; smooth_path++) {
+		if (smooth_path->movement == MOVE_FRONT)
+			distance += smooth_path->count * CELL_DIMENSION;
+		else if (smooth_path->movement == MOVE_DIAGONAL)
+			distance += smooth_path->count * CELL_DIAGONAL;
+		else if (smooth_path->movement == MOVE_STOP)
+			return distance - CELL_DIMENSION / 2;
+		else if (_is_speed_turn(smooth_path->movement))
+			return distance +
+			       get_move_turn_before(smooth_path->movement);
+	}
+	return distance;
+}
+
+/**
+ * @brief Advance a smooth path up to its next node.
+ *
+ * Nodes are the turns, the start, the stop and the end of the path. The
+ * distance of the straight movements found on the way is accumulated.
+ *
+ * @param[in] smooth_path Sequence of smooth movements.
+ * @param[in,out] distance Straight distance to accumulate, in meters.
+ *
+ * @return The next node of the path.
+ */
+static struct smooth_step *_next_path_node(struct smooth_step *smooth_path,
+					   float *distance)
+{
+	for (;; smooth_path++) {
+		if (smooth_path->movement == MOVE_FRONT)
+			*distance += smooth_path->count * CELL_DIMENSION;
+		else if (smooth_path->movement == MOVE_DIAGONAL)
+			*distance += smooth_path->count * CELL_DIAGONAL;
+		else
+			return smooth_path;
+	}
+}
+
+/**
+ * @brief Select the variant with which to execute a smooth path turn.
+ *
+ * The turn takes the largest variant that fits the straight distance left by
+ * the previous turn and the straight distance available up to the next one.
+ * The next turn can always fit then, at least with its tightest variant.
+ *
+ * @param[in] turn Sequence of smooth movements, starting at the turn.
+ * @param[in] distance Straight distance since the previous node, in meters.
+ */
+static int _select_turn_variant(struct smooth_step *turn, float distance)
+{
+	return get_turn_variant(turn->movement, distance,
+				_get_straight_after_turn(turn + 1));
+}
+
+/**
+ * @brief Plan the linear speed at which to execute a smooth path turn.
+ *
+ * The speed is capped by the turn linear speed and by what can be reached
+ * accelerating from the previous node. It is also limited to what allows
+ * braking to each of the next `TURN_PLAN_WINDOW` turns, selecting their
+ * variants as the executor does, and to the stop or the end of the path if
+ * they are within the window. Otherwise, the robot must be able to stop right
+ * after the last turn of the window.
+ *
+ * @param[in] turn Sequence of smooth movements, starting at the turn.
+ * @param[in] variant Variant of the turn.
+ * @param[in] force Maximum force to apply on the tires.
+ * @param[in] distance Straight distance from the previous node, in meters.
+ * @param[in] previous_speed Linear speed at the previous node.
+ * @param[in] end_speed Linear speed at the end of the path.
+ */
+static float _plan_turn_speed(struct smooth_step *turn, int variant,
+			      float force, float distance,
+			      float previous_speed, float end_speed)
+{
+	int i;
+	float speed;
+	float next_speed = 0.;
+	enum movement movement = turn->movement;
+	float speeds[TURN_PLAN_WINDOW];
+	float distances[TURN_PLAN_WINDOW];
+	float deceleration = get_linear_deceleration();
+
+	speed = get_reachable_speed(previous_speed, fmaxf(distance, 0),
+				    get_linear_acceleration());
+	speed = fminf(speed, get_max_linear_speed());
+	speed = fminf(speed,
+		      get_turn_variant_linear_speed(movement, variant, force));
+	distance = get_turn_variant_after(movement, variant);
+	for (i = 0; i < TURN_PLAN_WINDOW; i++) {
+		turn = _next_path_node(turn + 1, &distance);
+		movement = turn->movement;
+		if (!_is_speed_turn(movement))
 			break;
-		angular_velocity = max_angular_velocity;
-		if (time < transition) {
-			factor = time / transition;
-			angular_velocity *= sin(factor * PI / 2);
-		} else if (time >= transition + arc) {
-			factor = (time - arc) / transition;
-			angular_velocity *= sin(factor * PI / 2);
-		}
-		set_ideal_angular_speed(angular_velocity);
+		variant = _select_turn_variant(turn, distance);
+		distances[i] = distance + get_turn_variant_before(movement,
+								  variant);
+		speeds[i] =
+		    get_turn_variant_linear_speed(movement, variant, force);
+		distance = get_turn_variant_after(movement, variant);
 	}
-	set_ideal_angular_speed(0);
+	if (i < TURN_PLAN_WINDOW && movement == MOVE_STOP)
+		distance -= CELL_DIMENSION / 2;
+	else if (i < TURN_PLAN_WINDOW)
+		next_speed = end_speed;
+	for (i--; i >= 0; i--) {
+		next_speed = fminf(speeds[i],
+				   get_reachable_speed(next_speed,
+						       fmaxf(distance, 0),
+						       deceleration));
+		distance = distances[i];
+	}
+	return fminf(speed, get_reachable_speed(next_speed, fmaxf(distance, 0),
+						deceleration));
 }
 
 /**
- * @brief Execute a movement sequence.
+ * @brief Execute a smooth path from a given initial distance and speed.
  *
- * The sequence is a raw/sharp path, which will be smoothed before execution.
+ * Turn variants and speeds are planned when each turn is reached, so that
+ * each turn is as fast as its surrounding straights allow and each straight
+ * segment ends at a speed from which the next turns can be followed. Any
+ * distance left after the last movement is travelled ending at the given end
+ * speed.
  *
- * @param[in] sequence Sequence of raw movements to execute.
+ * Motions are queued ahead of their execution, which happens on the SYSTICK.
+ * This function only waits when the motion queue is full, before the final
+ * turn to the start position and for the path to be completed.
+ *
+ * @param[in] smooth_path Sequence of smooth movements to execute.
  * @param[in] force Maximum force to apply on the tires.
- * @param[in] language Language to use for the raw-to-smooth path translation.
+ * @param[in] distance Initial straight distance to travel, in meters.
+ * @param[in] end_speed Linear speed at the end of the path.
  */
-void execute_movement_sequence(char *sequence, float force,
-			       enum path_language language)
+static void _execute_smooth_path(struct smooth_step *smooth_path, float force,
+				 float distance, float end_speed)
 {
 	int i = 0;
-	int many = 0;
-	char movement;
-	float distance = 0;
-	enum movement smooth_path[MAX_SMOOTH_PATH_LEN];
+	int count;
+	int variant = 0;
+	float speed = get_ideal_linear_speed();
+	enum movement movement;
 
-	make_smooth_path(sequence, smooth_path, language);
 	while (true) {
-		movement = smooth_path[i++];
+		movement = smooth_path[i].movement;
+		count = smooth_path[i++].count;
+		if (_is_speed_turn(movement)) {
+			variant = _select_turn_variant(&smooth_path[i - 1],
+						       distance);
+			distance += get_turn_variant_before(movement, variant);
+			speed = _plan_turn_speed(&smooth_path[i - 1], variant,
+						 force, distance, speed,
+						 end_speed);
+		}
 		switch (movement) {
 		case MOVE_START:
 			distance = -MOUSE_START_SHIFT;
+			speed = 0.;
 			break;
 		case MOVE_FRONT:
+			distance += count * CELL_DIMENSION;
+			break;
 		case MOVE_DIAGONAL:
-			many = 0;
-			while (true) {
-				many += 1;
-				if (smooth_path[i] != movement)
-					break;
-				i++;
-			}
-			if (movement == MOVE_FRONT)
-				distance += many * CELL_DIMENSION;
-			else
-				distance += many * CELL_DIAGONAL;
+			distance += count * CELL_DIAGONAL;
 			break;
 		case MOVE_LEFT:
 		case MOVE_RIGHT:
@@ -514,18 +726,18 @@ void execute_movement_sequence(char *sequence, float force,
 		case MOVE_RIGHT_90:
 		case MOVE_LEFT_180:
 		case MOVE_RIGHT_180:
+		case MOVE_LEFT_90_LARGE:
+		case MOVE_RIGHT_90_LARGE:
+		case MOVE_LEFT_180_LARGE:
+		case MOVE_RIGHT_180_LARGE:
 		case MOVE_LEFT_TO_45:
 		case MOVE_RIGHT_TO_45:
 		case MOVE_LEFT_TO_135:
 		case MOVE_RIGHT_TO_135:
-			distance += get_move_turn_before(movement);
-			side_sensors_close_control(true);
-			side_sensors_far_control(false);
-			parametric_move_front(
-			    distance,
-			    get_move_turn_linear_speed(movement, force));
-			speed_turn(movement, force);
-			distance = get_move_turn_after(movement);
+			enqueue_straight(MOTION_CURRENT_POSITION, distance,
+					 speed, MOTION_CONTROL_SIDE_CLOSE);
+			enqueue_speed_turn_variant(movement, variant, speed);
+			distance = get_turn_variant_after(movement, variant);
 			break;
 		case MOVE_LEFT_FROM_45:
 		case MOVE_RIGHT_FROM_45:
@@ -533,27 +745,33 @@ void execute_movement_sequence(char *sequence, float force,
 		case MOVE_RIGHT_FROM_135:
 		case MOVE_LEFT_DIAGONAL:
 		case MOVE_RIGHT_DIAGONAL:
-			distance += get_move_turn_before(movement);
-			side_sensors_close_control(false);
-			side_sensors_far_control(false);
-			parametric_move_diagonal(
-			    distance, (distance - CELL_DIAGONAL * 2),
-			    get_move_turn_linear_speed(movement, force));
-			speed_turn(movement, force);
-			distance = get_move_turn_after(movement);
+			enqueue_diagonal(distance,
+					 (distance - CELL_DIAGONAL * 2), speed);
+			enqueue_speed_turn_variant(movement, variant, speed);
+			distance = get_turn_variant_after(movement, variant);
 			break;
 		case MOVE_STOP:
 			distance -= CELL_DIMENSION / 2;
-			side_sensors_close_control(true);
-			side_sensors_far_control(false);
-			parametric_move_front(distance, 0.);
+			enqueue_straight(MOTION_CURRENT_POSITION, distance, 0.,
+					 MOTION_CONTROL_SIDE_CLOSE);
+			distance = 0;
+			speed = 0.;
+			wait_motion_queue_empty();
+			if (collision_detected())
+				break;
 			turn_to_start_position(force);
 			speaker_play_success();
 			break;
 		case MOVE_END:
+			if (distance > 0)
+				enqueue_straight(MOTION_CURRENT_POSITION,
+						 distance, end_speed,
+						 MOTION_CONTROL_SIDE_CLOSE);
+			wait_motion_queue_empty();
 			return;
 		default:
 			LOG_ERROR("Unable to process command [%d]!", movement);
+			wait_motion_queue_empty();
 			return;
 		}
 		if (collision_detected()) {
@@ -562,3 +780,68 @@ void execute_movement_sequence(char *sequence, float force,
 		}
 	}
 }
+
+/**
+ * @brief Execute a smooth path, from the start to the stop.
+ *
+ * @param[in] smooth_path Sequence of smooth movements to execute.
+ * @param[in] force Maximum force to apply on the tires.
+ */
+void execute_smooth_path(struct smooth_step *smooth_path, float force)
+{
+	_execute_smooth_path(smooth_path, force, 0., 0.);
+}
+
+/**
+ * @brief Move through already explored cells without stopping.
+ *
+ * The sequence is a raw path which starts and ends with a front step, to be
+ * executed from the current cell. The robot ends entering the last cell at the
+ * given speed, ready to continue moving cell by cell.
+ *
+ * @param[in] sequence Sequence of raw movements to execute.
+ * @param[in] force Maximum force to apply on the tires.
+ * @param[in] end_speed Linear speed when entering the last cell.
+ *
+ * @return Whether the whole sequence was executed, which is not the case if
+ * it was too long to be smoothed or if a collision was detected.
+ */
+bool move_through_explored(char *sequence, float force, float end_speed)
+{
+	struct smooth_step smooth_path[MAX_SMOOTH_PATH_LEN];
+
+	wait_next_cell();
+	if (!make_smooth_path(sequence, smooth_path, MAX_SMOOTH_PATH_LEN,
+			      PATH_DIAGONALS)) {
+		LOG_ERROR("Smooth path too long!");
+		return false;
+	}
+	_execute_smooth_path(smooth_path, force, -_current_cell_shift(),
+			     end_speed);
+	if (collision_detected())
+		return false;
+	_entered_next_cell();
+	return true;
+}
+
+/**
+ * @brief Execute a movement sequence.
+ *
+ * The sequence is a raw/sharp path, which will be smoothed before execution.
+ *
+ * @param[in] sequence Sequence of raw movements to execute.
+ * @param[in] force Maximum force to apply on the tires.
+ * @param[in] language Language to use for the raw-to-smooth path translation.
+ */
+void execute_movement_sequence(char *sequence, float force,
+			       enum path_language language)
+{
+	struct smooth_step smooth_path[MAX_SMOOTH_PATH_LEN];
+
+	if (!make_smooth_path(sequence, smooth_path, MAX_SMOOTH_PATH_LEN,
+			      language)) {
+		LOG_ERROR("Smooth path too long!");
+		return;
+	}
+	execute_smooth_path(smooth_path, force);
+}
@@ -7,6 +7,8 @@
 #include "mmlib/control.h"
 #include "mmlib/hmi.h"
 #include "mmlib/logging.h"
+#include "mmlib/motion.h"
+#include "mmlib/odometry.h"
 #include "mmlib/path.h"
 #include "mmlib/search.h"
 #include "mmlib/speed.h"
@@ -15,7 +17,18 @@
 #include "motor.h"
 #include "setup.h"
 
+/**
+ * Number of turns ahead taken into account when planning the speed of a turn.
+ *
+ * It must cover the distance needed to brake from the maximum linear speed
+ * to the slowest turn, or turns would be executed slower than required.
+ */
+#ifndef TURN_PLAN_WINDOW
+#define TURN_PLAN_WINDOW 8
+#endif
+
 void set_starting_position(void);
+void wait_next_cell(void);
 int32_t required_micrometers_to_speed(float speed);
 float required_time_to_speed(float speed);
 uint32_t required_ticks_to_speed(float speed);
@@ -33,7 +46,11 @@ void parametric_move_diagonal(float distance, float control_distance,
 void move_side(enum movement turn, float force);
 void move_back(float force);
 void move(enum step_direction direction, float force);
+float required_time_to_turn_in_place(float radians, float force);
+float required_time_to_move_back(float force);
 void inplace_turn(float radians, float force);
+void execute_smooth_path(struct smooth_step *smooth_path, float force);
+bool move_through_explored(char *sequence, float force, float end_speed);
 void execute_movement_sequence(char *sequence, float force,
 			       enum path_language language);
 
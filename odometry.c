@@ -0,0 +1,98 @@
+#include "odometry.h"
+
+/**
+ * Odometry static variables.
+ *
+ * - Latest estimated pose
+ * - Counter increased before and after each pose update, so that readers can
+ *   detect an update in the middle of a read
+ */
+static volatile struct pose pose;
+static volatile uint32_t pose_updates;
+
+/**
+ * @brief Wrap an angle to the range [-PI, PI).
+ */
+static float wrap_angle(float angle)
+{
+	while (angle >= PI)
+		angle -= 2 * PI;
+	while (angle < -PI)
+		angle += 2 * PI;
+	return angle;
+}
+
+/**
+ * @brief Set the current pose of the robot.
+ *
+ * Speeds are kept, as they are measured on each update.
+ *
+ * @param[in] x Position along the X axis, in meters.
+ * @param[in] y Position along the Y axis, in meters.
+ * @param[in] heading Heading, in radians, counter-clockwise from the X axis.
+ */
+void set_odometry_pose(float x, float y, float heading)
+{
+	pose_updates++;
+	pose.x = x;
+	pose.y = y;
+	pose.heading = wrap_angle(heading);
+	pose_updates++;
+}
+
+/**
+ * @brief Get a consistent copy of the latest estimated pose.
+ *
+ * The pose is updated from the SYSTICK. The copy is retried if an update
+ * happens while it is being made.
+ */
+struct pose get_odometry_pose(void)
+{
+	uint32_t updates;
+	struct pose copy;
+
+	do {
+		updates = pose_updates;
+		copy.x = pose.x;
+		copy.y = pose.y;
+		copy.heading = pose.heading;
+		copy.linear_speed = pose.linear_speed;
+		copy.angular_speed = pose.angular_speed;
+	} while (updates != pose_updates);
+	return copy;
+}
+
+/**
+ * @brief Update the estimated pose with the latest sensor readings.
+ *
+ * It must be called from the SYSTICK, right after `update_encoder_readings()`
+ * and `update_gyro_readings()`.
+ *
+ * - The linear speed is the average speed of both wheels.
+ * - The angular speed is a complementary blend of the gyroscope and the
+ *   encoders measurements, weighted with `ODOMETRY_GYRO_WEIGHT`.
+ * - The position is advanced along the heading in the middle of the period.
+ */
+void update_odometry(void)
+{
+	float linear_speed;
+	float angular_speed;
+	float heading_change;
+	float travelled;
+
+	linear_speed =
+	    (get_encoder_left_speed() + get_encoder_right_speed()) / 2.;
+	angular_speed = ODOMETRY_GYRO_WEIGHT * get_gyro_z_radps() -
+			(1 - ODOMETRY_GYRO_WEIGHT) *
+			    get_encoder_angular_speed();
+	heading_change = angular_speed / SYSTICK_FREQUENCY_HZ;
+	travelled = linear_speed / SYSTICK_FREQUENCY_HZ;
+
+	pose_updates++;
+	pose.x += travelled * cos(pose.heading + heading_change / 2);
+	pose.y += travelled * sin(pose.heading + heading_change / 2);
+	pose.heading = wrap_angle(pose.heading + heading_change);
+	pose.linear_speed = linear_speed;
+	pose.angular_speed = angular_speed;
+	pose_updates++;
+}
@@ -0,0 +1,48 @@
+#ifndef __ODOMETRY_H
+#define __ODOMETRY_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "mmlib/encoder.h"
+#include "mmlib/mpu.h"
+
+#include "config.h"
+#include "setup.h"
+
+/**
+ * Weight of the gyroscope in the measured angular speed.
+ *
+ * The rest of the weight is given to the angular speed measured with the
+ * encoders, which is noisier and affected by wheel slip in turns, but does
+ * not drift when the robot is not rotating.
+ */
+#ifndef ODOMETRY_GYRO_WEIGHT
+#define ODOMETRY_GYRO_WEIGHT 0.98
+#endif
+
+/**
+ * A planar pose of the robot, with its speeds.
+ *
+ * Position is expressed in a fixed frame with the X axis pointing east and
+ * the Y axis pointing north. Heading is measured counter-clockwise from the X
+ * axis.
+ *
+ * - Position, in meters
+ * - Heading, in radians, in the range [-PI, PI)
+ * - Linear speed, in meters per second
+ * - Angular speed, in radians per second, counter-clockwise
+ */
+struct pose {
+	float x;
+	float y;
+	float heading;
+	float linear_speed;
+	float angular_speed;
+};
+
+void set_odometry_pose(float x, float y, float heading);
+struct pose get_odometry_pose(void);
+void update_odometry(void);
+
+#endif /* __ODOMETRY_H */
@@ -1,14 +1,22 @@
 #include "path.h"
 
-enum path_state {
-	ORTHOGONAL, /**< When coming from an orthogonal movement */
-	DIAGONAL,   /**< When coming from diagonal movement */
-	PATH_STATES_COUNT,
-};
+#define MAX_TRANSLATION_NODES 24
+#define RAW_MOVEMENTS_COUNT 3
 
-struct translation {
-	char *from;
-	enum movement to;
+/**
+ * A node of a translation table.
+ *
+ * - Next node for each raw movement (front, left and right), or zero if no
+ *   pattern continues with it
+ * - Position in the dictionary, starting at one, of the pattern ending in the
+ *   node, or zero if none does
+ * - Smooth path movement and length of the pattern ending in the node
+ */
+struct translation_node {
+	uint8_t next[RAW_MOVEMENTS_COUNT];
+	uint8_t priority;
+	uint8_t to;
+	uint8_t length;
 };
 
 // clang-format off
@@ -45,34 +53,196 @@ static struct translation *dictionary[LANGUAGES_COUNT][PATH_STATES_COUNT] = {
 	    {"", MOVE_NONE},
 	},
     },
+    [PATH_DIAGONALS_FAST] = {
+	[ORTHOGONAL] = (struct translation[]){
+	    {"LFLF", MOVE_LEFT_180_LARGE}, {"RFRF", MOVE_RIGHT_180_LARGE},
+	    {"LFF", MOVE_LEFT_90_LARGE},   {"RFF", MOVE_RIGHT_90_LARGE},
+	    {"LF", MOVE_LEFT_90},          {"RF", MOVE_RIGHT_90},
+	    {"LR", MOVE_LEFT_TO_45},       {"RL", MOVE_RIGHT_TO_45},
+	    {"LLF", MOVE_LEFT_180},        {"RRF", MOVE_RIGHT_180},
+	    {"LLR", MOVE_LEFT_TO_135},     {"RRL", MOVE_RIGHT_TO_135},
+	    {"", MOVE_NONE},
+	},
+	[DIAGONAL] = (struct translation[]){
+	    {"LR", MOVE_DIAGONAL},       {"RL", MOVE_DIAGONAL},
+	    {"LF", MOVE_LEFT_FROM_45},   {"RF", MOVE_RIGHT_FROM_45},
+	    {"LLR", MOVE_LEFT_DIAGONAL}, {"RRL", MOVE_RIGHT_DIAGONAL},
+	    {"LLF", MOVE_LEFT_FROM_135}, {"RRF", MOVE_RIGHT_FROM_135},
+	    {"", MOVE_NONE},
+	},
+    },
 };
 // clang-format on
 
+/**
+ * Dictionaries compiled into translation tables, on first use.
+ */
+static struct translation_node translation_tables
+    [LANGUAGES_COUNT][PATH_STATES_COUNT][MAX_TRANSLATION_NODES];
+static bool dictionary_compiled;
+
+/**
+ * @brief Get the list of translations for a language and path state.
+ *
+ * The list is terminated with an empty translation to `MOVE_NONE`.
+ *
+ * @param[in] language Language to get the translations for.
+ * @param[in] state Path state to get the translations for.
+ *
+ * @return The list of translations.
+ */
+struct translation *get_path_translations(enum path_language language,
+					  enum path_state state)
+{
+	return dictionary[language][state];
+}
+
+/**
+ * @brief Return the index of a raw path movement in the translation tables.
+ *
+ * @param[in] movement Raw path movement character.
+ *
+ * @return The index, or -1 if the movement is not part of any translation.
+ */
+static int raw_movement_index(char movement)
+{
+	switch (movement) {
+	case 'F':
+		return 0;
+	case 'L':
+		return 1;
+	case 'R':
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * @brief Compile a dictionary into a translation table.
+ *
+ * Each node is reached after reading a prefix of the raw path patterns. When
+ * a pattern ends in a node, the node keeps its position in the dictionary,
+ * so that the first matching pattern can be selected as with a linear scan.
+ *
+ * @param[in] candidate Dictionary translations to compile.
+ * @param[out] nodes Table to write the compiled translations to.
+ */
+static void compile_translations(struct translation *candidate,
+				 struct translation_node *nodes)
+{
+	int i;
+	int node;
+	int index;
+	int count = 1;
+	uint8_t priority = 1;
+
+	for (; candidate->to != MOVE_NONE; candidate++, priority++) {
+		node = 0;
+		for (i = 0; candidate->from[i] != '\0'; i++) {
+			index = raw_movement_index(candidate->from[i]);
+			if (!nodes[node].next[index]) {
+				if (count == MAX_TRANSLATION_NODES)
+					break;
+				nodes[node].next[index] = count++;
+			}
+			node = nodes[node].next[index];
+		}
+		if (candidate->from[i] != '\0' || nodes[node].priority)
+			continue;
+		nodes[node].priority = priority;
+		nodes[node].to = candidate->to;
+		nodes[node].length = i;
+	}
+}
+
+/**
+ * @brief Compile all the dictionaries into translation tables, only once.
+ */
+static void compile_dictionary(void)
+{
+	int language;
+	int state;
+
+	if (dictionary_compiled)
+		return;
+	for (language = 0; language < LANGUAGES_COUNT; language++) {
+		for (state = 0; state < PATH_STATES_COUNT; state++)
+			compile_translations(
+			    dictionary[language][state],
+			    translation_tables[language][state]);
+	}
+	dictionary_compiled = true;
+}
+
 /**
  * @brief Translate the source path to a smooth path.
  *
+ * The translation table is followed with the source path movements, keeping
+ * the first pattern of the dictionary that matches.
+ *
  * @param[in] source Raw path to translate from.
  * @param[in] path_language Language to use for the translation.
  * @param[in] path_state The current path state.
+ * @param[out] length Length of the matching pattern.
  *
- * @return The translated next movement.
+ * @return The translated next movement, or `MOVE_NONE` if no pattern matches.
  */
-static struct translation translate(char *source, enum path_language language,
-				    enum path_state state)
+static enum movement translate(char *source, enum path_language language,
+			       enum path_state state, int *length)
 {
-	int length;
-	struct translation *candidate;
+	int index;
+	int node = 0;
+	uint8_t priority = UINT8_MAX;
+	enum movement translated = MOVE_NONE;
+	struct translation_node *nodes = translation_tables[language][state];
 
-	candidate = dictionary[language][state];
 	while (true) {
-		length = strlen(candidate->from);
-		if (!length)
+		index = raw_movement_index(*source++);
+		if (index < 0 || !nodes[node].next[index])
 			break;
-		if (!strncmp(source, candidate->from, length))
-			return *candidate;
-		candidate++;
+		node = nodes[node].next[index];
+		if (nodes[node].priority && nodes[node].priority < priority) {
+			priority = nodes[node].priority;
+			translated = nodes[node].to;
+			*length = nodes[node].length;
+		}
 	}
-	return *candidate;
+	return translated;
+}
+
+/**
+ * @brief Append a movement to a smooth path.
+ *
+ * Straight movements are merged with the last step of the path when it is the
+ * same movement, as long as its count does not overflow.
+ *
+ * @param[in, out] smooth_path Smooth path to append the movement to.
+ * @param[in, out] length Number of steps in the smooth path.
+ * @param[in] size Maximum number of steps of the smooth path.
+ * @param[in] movement Movement to append.
+ *
+ * @return Whether the movement fits in the smooth path.
+ */
+bool append_smooth_movement(struct smooth_step *smooth_path, int *length,
+			    int size, enum movement movement)
+{
+	struct smooth_step *last;
+
+	if (*length > 0 &&
+	    (movement == MOVE_FRONT || movement == MOVE_DIAGONAL)) {
+		last = &smooth_path[*length - 1];
+		if (last->movement == movement && last->count < UINT8_MAX) {
+			last->count++;
+			return true;
+		}
+	}
+	if (*length >= size)
+		return false;
+	smooth_path[*length].movement = movement;
+	smooth_path[*length].count = 1;
+	(*length)++;
+	return true;
 }
 
 /**
@@ -80,39 +250,46 @@ static struct translation translate(char *source, enum path_language language,
  *
  * @param[in] source Raw path to smooth.
  * @param[out] destination Array to write the smooth path to.
+ * @param[in] size Size of the smooth path array, in steps.
  * @param[in] path_language Language to use for the translation.
+ *
+ * @return Whether the smooth path fits in the array.
  */
-void make_smooth_path(char *source, enum movement *destination,
-		      enum path_language language)
+bool make_smooth_path(char *source, struct smooth_step *destination,
+		      int size, enum path_language language)
 {
+	int length = 0;
+	int consumed;
+	enum movement movement;
 	enum path_state state = DIAGONAL;
-	struct translation translated;
 
-	while (true) {
-		if (*source == '\0')
-			break;
+	if (size < 1)
+		return false;
+	compile_dictionary();
+	while (*source != '\0') {
+		consumed = 1;
 		if (*source == 'B') {
-			*destination++ = MOVE_START;
-			source++;
-			continue;
-		}
-		if (*source == 'S') {
-			*destination++ = MOVE_STOP;
-			source++;
-			continue;
-		}
-		if (*source == 'F') {
+			movement = MOVE_START;
+		} else if (*source == 'S') {
+			movement = MOVE_STOP;
+		} else if (*source == 'F') {
+			movement = MOVE_FRONT;
 			state = ORTHOGONAL;
-			*destination++ = MOVE_FRONT;
-			source++;
-			continue;
-		}
-		translated = translate(source, language, state);
-		if (translated.to != MOVE_NONE) {
-			*destination++ = translated.to;
-			source += strlen(translated.from) - 1;
+		} else {
+			movement = translate(source, language, state,
+					     &consumed);
+			state = DIAGONAL;
+			if (movement == MOVE_NONE)
+				continue;
+			/* The last pattern character is only a lookahead */
+			consumed--;
 		}
-		state = DIAGONAL;
+		if (!append_smooth_movement(destination, &length, size - 1,
+					    movement))
+			return false;
+		source += consumed;
 	}
-	*destination = MOVE_END;
+	destination[length].movement = MOVE_END;
+	destination[length].count = 0;
+	return true;
 }
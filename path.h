@@ -2,11 +2,13 @@
 #define __PATH_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 
 enum path_language {
-	PATH_SAFE,      /**< Do not generate smooth diagonals */
-	PATH_DIAGONALS, /**< Generate smooth diagonals */
+	PATH_SAFE,           /**< Do not generate smooth diagonals */
+	PATH_DIAGONALS,      /**< Generate smooth diagonals */
+	PATH_DIAGONALS_FAST, /**< Also generate large turns around straights */
 	LANGUAGES_COUNT,
 };
 
@@ -33,10 +35,49 @@ enum movement {
 	MOVE_DIAGONAL,
 	MOVE_LEFT_DIAGONAL,
 	MOVE_RIGHT_DIAGONAL,
+	MOVE_LEFT_90_LARGE,
+	MOVE_RIGHT_90_LARGE,
+	MOVE_LEFT_180_LARGE,
+	MOVE_RIGHT_180_LARGE,
 	MOVE_NONE,
 };
 
-void make_smooth_path(char *raw_path, enum movement *smooth_path,
-		      enum path_language language);
+enum path_state {
+	ORTHOGONAL, /**< When coming from an orthogonal movement */
+	DIAGONAL,   /**< When coming from diagonal movement */
+	PATH_STATES_COUNT,
+};
+
+/**
+ * Translation from a raw path pattern to a smooth path movement.
+ *
+ * The last character of the pattern is not consumed by the translation: it
+ * is only a lookahead, to be translated next.
+ */
+struct translation {
+	char *from;
+	enum movement to;
+};
+
+/**
+ * A step of a smooth path: a movement and how many times it is repeated.
+ *
+ * Only straight movements (front and diagonal) are repeated. A smooth path is
+ * terminated with a `MOVE_END` step.
+ *
+ * - Movement, as an `enum movement`
+ * - Number of consecutive times the movement is executed
+ */
+struct smooth_step {
+	uint8_t movement;
+	uint8_t count;
+};
+
+struct translation *get_path_translations(enum path_language language,
+					  enum path_state state);
+bool append_smooth_movement(struct smooth_step *smooth_path, int *length,
+			    int size, enum movement movement);
+bool make_smooth_path(char *raw_path, struct smooth_step *smooth_path,
+		      int size, enum path_language language);
 
 #endif /* __PATH_H */
@@ -0,0 +1,959 @@
+#include "planner.h"
+
+#define HEADINGS 4
+#define PLAN_STATES (MAZE_AREA * HEADINGS * PLAN_CONTEXTS_COUNT)
+#define MAX_PLAN_COST UINT16_MAX
+#define MAX_PLAN_EDGES 40
+#define MAX_SEQUENCE_STEPS 3
+#define MAX_SEQUENCE_EDGES 16
+
+/**
+ * Translation context of a planner state.
+ *
+ * Mimics the raw-to-smooth path translation: after moving front, the
+ * orthogonal translations are available. After any other movement, the last
+ * step of its pattern is left pending and only diagonal translations apply.
+ * Together with the heading of the last raw step and the path language, it
+ * defines the 8-way heading of the robot.
+ */
+enum plan_context {
+	PLAN_AFTER_FRONT,   /**< Orthogonal path state, no pending raw step */
+	PLAN_PENDING_FRONT, /**< Diagonal path state, pending front step */
+	PLAN_PENDING_LEFT,  /**< Diagonal path state, pending left step */
+	PLAN_PENDING_RIGHT, /**< Diagonal path state, pending right step */
+	PLAN_CONTEXTS_COUNT,
+};
+
+/**
+ * A transition between planner states through a smooth path movement.
+ */
+struct plan_edge {
+	enum movement move;
+	int state;
+};
+
+/**
+ * Planner static variables.
+ *
+ * - Headings, in clockwise order, and their wall bits.
+ * - Travel cost from the start to each planner state.
+ * - Circular queue and bitset of states queued for relaxation.
+ */
+static const int headings[HEADINGS] = {EAST, SOUTH, WEST, NORTH};
+static const uint8_t heading_bits[HEADINGS] = {EAST_BIT, SOUTH_BIT, WEST_BIT,
+					       NORTH_BIT};
+static uint16_t plan_costs[PLAN_STATES];
+static uint16_t plan_queue[PLAN_STATES];
+static uint8_t queued_states[PLAN_STATES / 8];
+
+static int plan_state(int cell, int heading, enum plan_context context)
+{
+	return (cell * HEADINGS + heading) * PLAN_CONTEXTS_COUNT + context;
+}
+
+static int state_cell(int state)
+{
+	return state / (HEADINGS * PLAN_CONTEXTS_COUNT);
+}
+
+static int state_heading(int state)
+{
+	return state / PLAN_CONTEXTS_COUNT % HEADINGS;
+}
+
+static enum plan_context state_context(int state)
+{
+	return state % PLAN_CONTEXTS_COUNT;
+}
+
+static int heading_index(enum compass_direction direction)
+{
+	int i;
+
+	for (i = 0; i < HEADINGS; i++)
+		if (headings[i] == direction)
+			return i;
+	return 0;
+}
+
+/**
+ * @brief Return whether a movement must start with a diagonal orientation.
+ */
+static bool movement_starts_diagonal(enum movement move)
+{
+	switch (move) {
+	case MOVE_LEFT_FROM_45:
+	case MOVE_RIGHT_FROM_45:
+	case MOVE_LEFT_FROM_135:
+	case MOVE_RIGHT_FROM_135:
+	case MOVE_DIAGONAL:
+	case MOVE_LEFT_DIAGONAL:
+	case MOVE_RIGHT_DIAGONAL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @brief Return the context with a pending raw step.
+ */
+static enum plan_context pending_context(char pending)
+{
+	switch (pending) {
+	case 'F':
+		return PLAN_PENDING_FRONT;
+	case 'L':
+		return PLAN_PENDING_LEFT;
+	default:
+		return PLAN_PENDING_RIGHT;
+	}
+}
+
+static char context_pending(enum plan_context context)
+{
+	switch (context) {
+	case PLAN_PENDING_FRONT:
+		return 'F';
+	case PLAN_PENDING_LEFT:
+		return 'L';
+	case PLAN_PENDING_RIGHT:
+		return 'R';
+	default:
+		return '\0';
+	}
+}
+
+/**
+ * @brief Return whether a translation can be applied in a planner context.
+ *
+ * Orthogonal translations can only follow a front movement. Diagonal
+ * translations must match the pending raw step, or follow a front movement
+ * if they start with an orthogonal orientation (i.e.: search turns, which
+ * are used when no orthogonal translation matches).
+ */
+static bool translation_applies(struct translation *candidate,
+				enum path_state path_state,
+				enum plan_context context)
+{
+	if (context == PLAN_AFTER_FRONT) {
+		if (path_state == ORTHOGONAL)
+			return true;
+		return !movement_starts_diagonal(candidate->to);
+	}
+	if (path_state == ORTHOGONAL)
+		return false;
+	return candidate->from[0] == context_pending(context);
+}
+
+/**
+ * @brief Return whether a cell side is known to be open.
+ */
+static bool side_is_open(int cell, int heading)
+{
+	uint8_t bit = heading_bits[heading];
+
+	if (read_cell_walls_value(cell) & bit)
+		return false;
+	return read_cell_known_walls_value(cell) & bit;
+}
+
+/**
+ * @brief Apply a raw step, turning inside the cell and exiting it.
+ *
+ * @return Whether the step is possible through known open sides.
+ */
+static bool raw_step(int *cell, int *heading, char step)
+{
+	if (step == 'L')
+		*heading = (*heading + HEADINGS - 1) % HEADINGS;
+	else if (step == 'R')
+		*heading = (*heading + 1) % HEADINGS;
+	if (!side_is_open(*cell, *heading))
+		return false;
+	*cell += headings[*heading];
+	return true;
+}
+
+/**
+ * @brief Undo a raw step, going back to the cell and heading it started at.
+ *
+ * @return Whether the step is possible through known open sides.
+ */
+static bool raw_step_back(int *cell, int *heading, char step)
+{
+	int previous = *cell - headings[*heading];
+
+	if (previous < 0 || previous >= MAZE_AREA)
+		return false;
+	if (!side_is_open(previous, *heading))
+		return false;
+	*cell = previous;
+	if (step == 'L')
+		*heading = (*heading + 1) % HEADINGS;
+	else if (step == 'R')
+		*heading = (*heading + HEADINGS - 1) % HEADINGS;
+	return true;
+}
+
+static int add_edge(struct plan_edge *edges, int count, enum movement move,
+		    int cell, int heading, enum plan_context context)
+{
+	edges[count].move = move;
+	edges[count].state = plan_state(cell, heading, context);
+	return count + 1;
+}
+
+/**
+ * @brief Get the movements that can be executed from a planner state.
+ *
+ * Movements other than moving front are taken from the raw-to-smooth path
+ * dictionary of the language. Each translation consumes all but the last
+ * step of its pattern, which is left pending for the next movement.
+ *
+ * @param[in] state Planner state to start from.
+ * @param[in] language Language which defines the available movements.
+ * @param[out] edges Array to write the transitions to.
+ *
+ * @return The number of transitions.
+ */
+static int state_successors(int state, enum path_language language,
+			    struct plan_edge *edges)
+{
+	int i;
+	int cell;
+	int heading;
+	int length;
+	int count = 0;
+	enum path_state path_state;
+	struct translation *candidate;
+	enum plan_context context = state_context(state);
+
+	cell = state_cell(state);
+	heading = state_heading(state);
+	if ((context == PLAN_AFTER_FRONT || context == PLAN_PENDING_FRONT) &&
+	    side_is_open(cell, heading))
+		count = add_edge(edges, count, MOVE_FRONT,
+				 cell + headings[heading], heading,
+				 PLAN_AFTER_FRONT);
+	for (path_state = 0; path_state < PATH_STATES_COUNT; path_state++) {
+		candidate = get_path_translations(language, path_state);
+		for (; candidate->to != MOVE_NONE; candidate++) {
+			if (!translation_applies(candidate, path_state,
+						 context))
+				continue;
+			cell = state_cell(state);
+			heading = state_heading(state);
+			length = strlen(candidate->from);
+			for (i = 0; i < length - 1; i++)
+				if (!raw_step(&cell, &heading,
+					      candidate->from[i]))
+					break;
+			if (i < length - 1)
+				continue;
+			count = add_edge(
+			    edges, count, candidate->to, cell, heading,
+			    pending_context(candidate->from[length - 1]));
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Get the movements that can lead to a planner state.
+ *
+ * @param[in] state Planner state to arrive to.
+ * @param[in] language Language which defines the available movements.
+ * @param[out] edges Array to write the transitions to, where each edge state
+ * is the state the movement starts from.
+ *
+ * @return The number of transitions.
+ */
+static int state_predecessors(int state, enum path_language language,
+			      struct plan_edge *edges)
+{
+	int i;
+	int cell;
+	int heading;
+	int length;
+	int count = 0;
+	enum path_state path_state;
+	enum plan_context previous;
+	struct translation *candidate;
+	enum plan_context context = state_context(state);
+
+	cell = state_cell(state);
+	heading = state_heading(state);
+	if (context == PLAN_AFTER_FRONT &&
+	    raw_step_back(&cell, &heading, 'F')) {
+		count = add_edge(edges, count, MOVE_FRONT, cell, heading,
+				 PLAN_AFTER_FRONT);
+		count = add_edge(edges, count, MOVE_FRONT, cell, heading,
+				 PLAN_PENDING_FRONT);
+	}
+	if (context == PLAN_AFTER_FRONT)
+		return count;
+	for (path_state = 0; path_state < PATH_STATES_COUNT; path_state++) {
+		candidate = get_path_translations(language, path_state);
+		for (; candidate->to != MOVE_NONE; candidate++) {
+			length = strlen(candidate->from);
+			if (pending_context(candidate->from[length - 1]) !=
+			    context)
+				continue;
+			cell = state_cell(state);
+			heading = state_heading(state);
+			for (i = length - 2; i >= 0; i--)
+				if (!raw_step_back(&cell, &heading,
+						   candidate->from[i]))
+					break;
+			if (i >= 0)
+				continue;
+			for (previous = 0; previous < PLAN_CONTEXTS_COUNT;
+			     previous++)
+				if (translation_applies(candidate, path_state,
+							previous))
+					count = add_edge(edges, count,
+							 candidate->to, cell,
+							 heading, previous);
+		}
+	}
+	return count;
+}
+
+/**
+ * @brief Set the travel cost from the start to every planner state.
+ *
+ * Label-correcting search: states are queued again whenever their cost is
+ * lowered, which keeps memory requirements low compared to a priority queue.
+ *
+ * @param[in] start Planner state to start from.
+ * @param[in] language Language which defines the available movements.
+ * @param[in] costs Cost of each movement.
+ */
+static void flood_plan(int start, enum path_language language,
+		       const uint16_t *costs)
+{
+	int i;
+	int count;
+	int state;
+	int head = 0;
+	int tail = 0;
+	int queued = 0;
+	uint32_t cost;
+	struct plan_edge edges[MAX_PLAN_EDGES];
+
+	for (i = 0; i < PLAN_STATES; i++)
+		plan_costs[i] = MAX_PLAN_COST;
+	memset(queued_states, 0, sizeof(queued_states));
+
+	plan_costs[start] = 0;
+	plan_queue[tail] = start;
+	tail = (tail + 1) % PLAN_STATES;
+	queued++;
+	queued_states[start / 8] |= 1 << (start % 8);
+	while (queued) {
+		state = plan_queue[head];
+		head = (head + 1) % PLAN_STATES;
+		queued--;
+		queued_states[state / 8] &= ~(1 << (state % 8));
+		count = state_successors(state, language, edges);
+		for (i = 0; i < count; i++) {
+			cost = plan_costs[state] + costs[edges[i].move];
+			if (cost >= plan_costs[edges[i].state])
+				continue;
+			plan_costs[edges[i].state] = cost;
+			if (queued_states[edges[i].state / 8] &
+			    (1 << (edges[i].state % 8)))
+				continue;
+			plan_queue[tail] = edges[i].state;
+			tail = (tail + 1) % PLAN_STATES;
+			queued++;
+			queued_states[edges[i].state / 8] |=
+			    1 << (edges[i].state % 8);
+		}
+	}
+}
+
+/**
+ * @brief Return whether the planned path can stop at a cell.
+ *
+ * @param[in] cell Cell to check.
+ * @param[in] to_goal Whether to stop at the goal, or at the target otherwise.
+ */
+static bool is_stop_cell(int cell, bool to_goal)
+{
+	if (to_goal)
+		return cell_is_goal(cell);
+	return read_cell_distance_value(cell) == 0;
+}
+
+/**
+ * @brief Return the cheapest planner state to stop from.
+ *
+ * The path ends moving front into the stop cell and stopping in the middle.
+ *
+ * @param[in] costs Cost of each movement.
+ * @param[in] to_goal Whether to stop at the goal, or at the target otherwise.
+ *
+ * @return The planner state or -1 if no stop cell is reachable.
+ */
+static int best_stop_state(const uint16_t *costs, bool to_goal)
+{
+	int cell;
+	int heading;
+	int state;
+	int best = -1;
+	uint32_t cost;
+	uint32_t best_cost = MAX_PLAN_COST;
+	enum plan_context context;
+
+	for (cell = 0; cell < MAZE_AREA; cell++) {
+		if (!is_stop_cell(cell, to_goal))
+			continue;
+		for (heading = 0; heading < HEADINGS; heading++) {
+			for (context = PLAN_AFTER_FRONT;
+			     context <= PLAN_PENDING_FRONT; context++) {
+				state = plan_state(cell, heading, context);
+				if (plan_costs[state] == MAX_PLAN_COST)
+					continue;
+				cost = plan_costs[state] + costs[MOVE_FRONT];
+				if (cost >= best_cost)
+					continue;
+				best = state;
+				best_cost = cost;
+			}
+		}
+	}
+	return best;
+}
+
+/**
+ * @brief Plan the fastest smooth path from the current search state.
+ *
+ * Instead of smoothing a raw path chosen in advance, the search is performed
+ * over (cell, heading, translation context) states, using the smooth path
+ * movements of the language as edges. This way, paths which are longer in
+ * cells but allow faster movements (i.e.: long diagonals) are considered.
+ *
+ * The robot starts as if it came from a front movement, and stops in the
+ * middle of the first stop cell it reaches. The search state is then set to
+ * that cell, with the direction of the last movement.
+ *
+ * Only known walls are considered open. Each movement cost must be strictly
+ * positive and should be proportional to its expected execution time.
+ *
+ * @param[out] smooth_path Array to write the smooth path to.
+ * @param[in] size Size of the smooth path array, in steps.
+ * @param[in] language Language which defines the available movements.
+ * @param[in] costs Cost of each movement, indexed by `enum movement`.
+ * @param[in] to_goal Whether to stop at the goal, or at the target otherwise.
+ *
+ * @return Whether a path to a stop cell was found.
+ */
+static bool plan_from_search_state(struct smooth_step *smooth_path,
+				   int size, enum path_language language,
+				   const uint16_t *costs, bool to_goal)
+{
+	int i;
+	int stop;
+	int count;
+	int start;
+	int state;
+	int length = 1;
+	struct smooth_step swap;
+	struct plan_edge edges[MAX_PLAN_EDGES];
+
+	start = plan_state(search_position(), heading_index(search_direction()),
+			   PLAN_AFTER_FRONT);
+	flood_plan(start, language, costs);
+	stop = best_stop_state(costs, to_goal);
+	if (stop < 0)
+		return false;
+
+	smooth_path[0].movement = MOVE_START;
+	smooth_path[0].count = 1;
+	state = stop;
+	while (state != start) {
+		count = state_predecessors(state, language, edges);
+		for (i = 0; i < count; i++)
+			if (plan_costs[edges[i].state] != MAX_PLAN_COST &&
+			    plan_costs[edges[i].state] + costs[edges[i].move] ==
+				plan_costs[state])
+				break;
+		if (i == count)
+			return false;
+		if (!append_smooth_movement(smooth_path, &length, size - 3,
+					    edges[i].move))
+			return false;
+		state = edges[i].state;
+	}
+	for (i = 1; i < length - i; i++) {
+		swap = smooth_path[i];
+		smooth_path[i] = smooth_path[length - i];
+		smooth_path[length - i] = swap;
+	}
+	append_smooth_movement(smooth_path, &length, size - 1, MOVE_FRONT);
+	append_smooth_movement(smooth_path, &length, size - 1, MOVE_STOP);
+	smooth_path[length].movement = MOVE_END;
+	smooth_path[length].count = 0;
+	set_search_state(state_cell(stop), headings[state_heading(stop)]);
+	return true;
+}
+
+/**
+ * @brief Plan the fastest smooth path from the start to the goal.
+ *
+ * The robot starts from the search initial state. See
+ * `plan_from_search_state()`.
+ *
+ * @param[out] smooth_path Array to write the smooth path to.
+ * @param[in] size Size of the smooth path array, in steps.
+ * @param[in] language Language which defines the available movements.
+ * @param[in] costs Cost of each movement, indexed by `enum movement`.
+ *
+ * @return Whether a path to the goal was found.
+ */
+bool plan_smooth_path(struct smooth_step *smooth_path, int size,
+		      enum path_language language, const uint16_t *costs)
+{
+	set_search_initial_state();
+	return plan_from_search_state(smooth_path, size, language, costs,
+				      true);
+}
+
+/**
+ * @brief Plan the fastest smooth path from the current search state to the
+ * target.
+ *
+ * The distances to the target must be set: the path stops at the first cell
+ * with zero distance it reaches. See `plan_from_search_state()`.
+ *
+ * @param[out] smooth_path Array to write the smooth path to.
+ * @param[in] size Size of the smooth path array, in steps.
+ * @param[in] language Language which defines the available movements.
+ * @param[in] costs Cost of each movement, indexed by `enum movement`.
+ *
+ * @return Whether a path to the target was found.
+ */
+bool plan_smooth_path_to_target(struct smooth_step *smooth_path, int size,
+				enum path_language language,
+				const uint16_t *costs)
+{
+	return plan_from_search_state(smooth_path, size, language, costs,
+				      false);
+}
+
+/**
+ * Translation context of a raw sequence state.
+ *
+ * Follows `make_smooth_path()` exactly: each raw step is translated as soon
+ * as the following steps are enough to select its translation. States are
+ * kept only where no raw step is pending or where a single turn step is
+ * pending in the diagonal path state. The pending step is already applied to
+ * the cell and heading of the state.
+ */
+enum sequence_context {
+	SEQUENCE_START,         /**< Diagonal path state, at the path start */
+	SEQUENCE_AFTER_FRONT,   /**< Orthogonal path state, no pending step */
+	SEQUENCE_PENDING_LEFT,  /**< Diagonal path state, pending left step */
+	SEQUENCE_PENDING_RIGHT, /**< Diagonal path state, pending right step */
+	SEQUENCE_CONTEXTS_COUNT,
+};
+
+/**
+ * A raw sequence being translated from a sequence state.
+ *
+ * - Cell and heading after the last raw step
+ * - Path state and raw steps not translated yet, as in `make_smooth_path()`
+ * - Raw steps added from the starting state
+ * - Cost of the movements translated so far
+ */
+struct sequence_walk {
+	int cell;
+	int heading;
+	enum path_state path_state;
+	char pending[MAX_SEQUENCE_STEPS + MAZE_SIZE + 2];
+	char steps[MAX_SEQUENCE_STEPS + 1];
+	uint32_t cost;
+};
+
+/**
+ * A transition between sequence states through some raw steps.
+ *
+ * The state is -1 when the raw steps reach the goal.
+ */
+struct sequence_edge {
+	char steps[MAX_SEQUENCE_STEPS + 1];
+	uint32_t cost;
+	int state;
+};
+
+/**
+ * Sequence states share the planner buffers. There are no more sequence
+ * contexts than planner contexts.
+ */
+static int sequence_state(int cell, int heading, enum sequence_context context)
+{
+	return (cell * HEADINGS + heading) * PLAN_CONTEXTS_COUNT + context;
+}
+
+/**
+ * @brief Apply a raw step along a shortest path to the target.
+ *
+ * @param[in] known_only Whether to consider unknown walls as existing.
+ *
+ * @return Whether the step reduces the distance to the target by one cell.
+ */
+static bool shortest_step(int *cell, int *heading, char step, bool known_only)
+{
+	int next;
+	uint8_t bit;
+
+	if (step == 'L')
+		*heading = (*heading + HEADINGS - 1) % HEADINGS;
+	else if (step == 'R')
+		*heading = (*heading + 1) % HEADINGS;
+	bit = heading_bits[*heading];
+	if (read_cell_walls_value(*cell) & bit)
+		return false;
+	if (known_only && !(read_cell_known_walls_value(*cell) & bit))
+		return false;
+	next = *cell + headings[*heading];
+	if (read_cell_distance_value(next) + 1 !=
+	    read_cell_distance_value(*cell))
+		return false;
+	*cell = next;
+	return true;
+}
+
+/**
+ * @brief Return the number of target cells straight ahead of a cell.
+ */
+static int targets_ahead(int cell, int heading)
+{
+	int count = 0;
+	int x = cell % MAZE_SIZE;
+	int y = cell / MAZE_SIZE;
+
+	while (true) {
+		if (heading == 0)
+			x++;
+		else if (heading == 1)
+			y--;
+		else if (heading == 2)
+			x--;
+		else
+			y++;
+		if (x < 0 || x >= MAZE_SIZE || y < 0 || y >= MAZE_SIZE)
+			break;
+		if (read_cell_distance_value(y * MAZE_SIZE + x) != 0)
+			break;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Translate the pending raw steps of a walk, as far as possible.
+ *
+ * Translations are selected as in `make_smooth_path()`. Translating stops
+ * when more raw steps are needed to select the next translation.
+ *
+ * @return Whether the pending steps are a valid raw path prefix.
+ */
+static bool translate_pending(struct sequence_walk *walk,
+			      enum path_language language,
+			      const uint16_t *costs)
+{
+	int length;
+	int pending;
+	struct translation *candidate;
+
+	while (true) {
+		pending = strlen(walk->pending);
+		if (!pending)
+			return true;
+		if (walk->pending[0] == 'F') {
+			walk->cost += costs[MOVE_FRONT];
+			walk->path_state = ORTHOGONAL;
+			memmove(walk->pending, walk->pending + 1, pending);
+			continue;
+		}
+		candidate = get_path_translations(language, walk->path_state);
+		for (; candidate->to != MOVE_NONE; candidate++) {
+			length = strlen(candidate->from);
+			if (!strncmp(walk->pending, candidate->from, length))
+				break;
+			if (!strncmp(walk->pending, candidate->from, pending))
+				return true;
+		}
+		if (candidate->to != MOVE_NONE) {
+			walk->cost += costs[candidate->to];
+			memmove(walk->pending, walk->pending + length - 1,
+				pending - length + 2);
+		} else if (walk->path_state == DIAGONAL) {
+			return false;
+		}
+		walk->path_state = DIAGONAL;
+	}
+}
+
+static int add_sequence_edge(struct sequence_edge *edges, int count,
+			     struct sequence_walk *walk, int state)
+{
+	if (count >= MAX_SEQUENCE_EDGES)
+		return count;
+	strcpy(edges[count].steps, walk->steps);
+	edges[count].cost = walk->cost;
+	edges[count].state = state;
+	return count + 1;
+}
+
+/**
+ * @brief Extend a walk with every raw step along a shortest path.
+ *
+ * Walks are extended until they reach a sequence state or the goal. When the
+ * goal is reached, the front steps appended to the run sequence to stop
+ * inside the goal are translated too.
+ *
+ * @return The total number of transitions.
+ */
+static int extend_walk(struct sequence_walk *walk, enum path_language language,
+		       const uint16_t *costs, bool known_only,
+		       struct sequence_edge *edges, int count)
+{
+	int i;
+	int length;
+	int pending;
+	struct sequence_walk next;
+	static const char steps[] = {'F', 'L', 'R'};
+
+	length = strlen(walk->steps);
+	if (length >= MAX_SEQUENCE_STEPS)
+		return count;
+	for (i = 0; i < 3; i++) {
+		next = *walk;
+		if (!shortest_step(&next.cell, &next.heading, steps[i],
+				   known_only))
+			continue;
+		next.steps[length] = steps[i];
+		next.steps[length + 1] = '\0';
+		pending = strlen(next.pending);
+		next.pending[pending++] = steps[i];
+		if (read_cell_distance_value(next.cell) == 0) {
+			memset(&next.pending[pending], 'F',
+			       targets_ahead(next.cell, next.heading) + 1);
+			pending += targets_ahead(next.cell, next.heading) + 1;
+		}
+		next.pending[pending] = '\0';
+		if (!translate_pending(&next, language, costs))
+			continue;
+		pending = strlen(next.pending);
+		if (read_cell_distance_value(next.cell) == 0)
+			count = add_sequence_edge(edges, count, &next, -1);
+		else if (!pending)
+			count = add_sequence_edge(
+			    edges, count, &next,
+			    sequence_state(next.cell, next.heading,
+					   SEQUENCE_AFTER_FRONT));
+		else if (pending == 1 && next.path_state == DIAGONAL)
+			count = add_sequence_edge(
+			    edges, count, &next,
+			    sequence_state(next.cell, next.heading,
+					   next.pending[0] == 'L'
+					       ? SEQUENCE_PENDING_LEFT
+					       : SEQUENCE_PENDING_RIGHT));
+		else
+			count = extend_walk(&next, language, costs, known_only,
+					    edges, count);
+	}
+	return count;
+}
+
+/**
+ * @brief Get the raw steps that can be executed from a sequence state.
+ *
+ * @param[in] state Sequence state to start from.
+ * @param[in] language Language used to translate the raw steps.
+ * @param[in] costs Cost of each movement.
+ * @param[in] known_only Whether to consider unknown walls as existing.
+ * @param[out] edges Array to write the transitions to.
+ *
+ * @return The number of transitions.
+ */
+static int sequence_successors(int state, enum path_language language,
+			       const uint16_t *costs, bool known_only,
+			       struct sequence_edge *edges)
+{
+	struct sequence_walk walk;
+	enum sequence_context context = state % PLAN_CONTEXTS_COUNT;
+
+	walk.cell = state_cell(state);
+	walk.heading = state_heading(state);
+	walk.path_state = DIAGONAL;
+	walk.pending[0] = '\0';
+	if (context == SEQUENCE_AFTER_FRONT)
+		walk.path_state = ORTHOGONAL;
+	else if (context == SEQUENCE_PENDING_LEFT)
+		strcpy(walk.pending, "L");
+	else if (context == SEQUENCE_PENDING_RIGHT)
+		strcpy(walk.pending, "R");
+	walk.steps[0] = '\0';
+	walk.cost = 0;
+	return extend_walk(&walk, language, costs, known_only, edges, 0);
+}
+
+/**
+ * @brief Return the cost of the cheapest transition from a sequence state.
+ *
+ * @param[in] edges Transitions from the state.
+ * @param[in] count Number of transitions.
+ * @param[out] best Index of the cheapest transition.
+ *
+ * @return The cost to reach the goal through the cheapest transition.
+ */
+static uint32_t best_sequence_edge(struct sequence_edge *edges, int count,
+				   int *best)
+{
+	int i;
+	uint32_t cost;
+	uint32_t best_cost = MAX_PLAN_COST;
+
+	for (i = 0; i < count; i++) {
+		cost = edges[i].cost;
+		if (edges[i].state >= 0) {
+			if (plan_costs[edges[i].state] == MAX_PLAN_COST)
+				continue;
+			cost += plan_costs[edges[i].state];
+		}
+		if (cost >= best_cost)
+			continue;
+		best_cost = cost;
+		*best = i;
+	}
+	return best_cost;
+}
+
+/**
+ * @brief Set the cost to reach the goal from every sequence state.
+ *
+ * Shortest paths form a directed acyclic graph, where each raw step reduces
+ * the distance to the target by one cell. The cells reachable from the start
+ * through that graph are sorted by their distance, and the cost of each state
+ * is computed after the cost of all the states that can follow it.
+ *
+ * @param[in] start Cell to start from.
+ * @param[in] language Language used to translate the raw steps.
+ * @param[in] costs Cost of each movement.
+ * @param[in] known_only Whether to consider unknown walls as existing.
+ */
+static void flood_sequence(int start, enum path_language language,
+			   const uint16_t *costs, bool known_only)
+{
+	int i;
+	int cell;
+	int next;
+	int best;
+	int count;
+	int state;
+	int heading;
+	int context;
+	int cells = 0;
+	struct sequence_edge edges[MAX_SEQUENCE_EDGES];
+
+	for (i = 0; i < PLAN_STATES; i++)
+		plan_costs[i] = MAX_PLAN_COST;
+	memset(queued_states, 0, sizeof(queued_states));
+
+	plan_queue[cells++] = start;
+	queued_states[start / 8] |= 1 << (start % 8);
+	for (i = 0; i < cells; i++) {
+		for (heading = 0; heading < HEADINGS; heading++) {
+			cell = plan_queue[i];
+			next = heading;
+			if (!shortest_step(&cell, &next, 'F', known_only))
+				continue;
+			if (queued_states[cell / 8] & (1 << (cell % 8)))
+				continue;
+			plan_queue[cells++] = cell;
+			queued_states[cell / 8] |= 1 << (cell % 8);
+		}
+	}
+
+	for (i = cells - 1; i >= 0; i--) {
+		for (heading = 0; heading < HEADINGS; heading++) {
+			for (context = 0; context < SEQUENCE_CONTEXTS_COUNT;
+			     context++) {
+				if (context == SEQUENCE_START && i > 0)
+					continue;
+				state = sequence_state(plan_queue[i], heading,
+						       context);
+				count = sequence_successors(state, language,
+							    costs, known_only,
+							    edges);
+				plan_costs[state] =
+				    best_sequence_edge(edges, count, &best);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Plan the fastest among the shortest raw paths to the target.
+ *
+ * Out of all the paths with the minimum number of cells to the target, the
+ * one whose smooth path translation is the fastest is selected. Paths are
+ * not enumerated: the cost to reach the target is computed for each (cell,
+ * heading, translation context) state, so planning grows linearly with the
+ * number of cells.
+ *
+ * The distances to the target must be set. The path starts from the search
+ * initial state.
+ *
+ * Large turns need to look past the front step that follows them, which the
+ * sequence states do not keep. Paths for `PATH_DIAGONALS_FAST` are selected
+ * as for `PATH_DIAGONALS` instead.
+ *
+ * @param[out] sequence Array to write the raw path to, as front, left and
+ * right steps, terminated with a null character.
+ * @param[in] size Size of the raw path array.
+ * @param[in] language Language used to translate the raw path.
+ * @param[in] costs Cost of each movement, indexed by `enum movement`.
+ * @param[in] known_only Whether to consider unknown walls as existing.
+ *
+ * @return Whether a path to the target was found.
+ */
+bool plan_shortest_sequence(char *sequence, int size,
+			    enum path_language language, const uint16_t *costs,
+			    bool known_only)
+{
+	int count;
+	int state;
+	int best = 0;
+	int length = 0;
+	struct sequence_edge edges[MAX_SEQUENCE_EDGES];
+
+	if (language == PATH_DIAGONALS_FAST)
+		language = PATH_DIAGONALS;
+	set_search_initial_state();
+	if (search_distance() == 0)
+		return false;
+	flood_sequence(search_position(), language, costs, known_only);
+	state = sequence_state(search_position(),
+			       heading_index(search_direction()),
+			       SEQUENCE_START);
+	if (plan_costs[state] == MAX_PLAN_COST)
+		return false;
+
+	while (state >= 0) {
+		count = sequence_successors(state, language, costs, known_only,
+					    edges);
+		best_sequence_edge(edges, count, &best);
+		if (length + (int)strlen(edges[best].steps) >= size)
+			return false;
+		strcpy(&sequence[length], edges[best].steps);
+		length += strlen(edges[best].steps);
+		state = edges[best].state;
+	}
+	return true;
+}
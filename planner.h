@@ -0,0 +1,20 @@
+#ifndef __PLANNER_H
+#define __PLANNER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mmlib/path.h"
+#include "mmlib/search.h"
+
+bool plan_smooth_path(struct smooth_step *smooth_path, int size,
+		      enum path_language language, const uint16_t *costs);
+bool plan_smooth_path_to_target(struct smooth_step *smooth_path, int size,
+				enum path_language language,
+				const uint16_t *costs);
+bool plan_shortest_sequence(char *sequence, int size,
+			    enum path_language language, const uint16_t *costs,
+			    bool known_only);
+
+#endif /* __PLANNER_H */
@@ -0,0 +1,95 @@
+"""
+Benchmark the smooth path translation on long random paths.
+
+The `path.c` module is compiled on the host and `make_smooth_path()` is timed
+for each language on a random raw path, reporting the time per raw movement.
+"""
+from pathlib import Path
+import random
+import sys
+from tempfile import TemporaryDirectory
+import timeit
+
+from cffi import FFI
+
+
+ROOT = Path(__file__).resolve().parent.parent
+
+LENGTH = 4096
+
+CDEF = '''
+enum path_language { PATH_SAFE, PATH_DIAGONALS, PATH_DIAGONALS_FAST, ... };
+struct smooth_step {
+    uint8_t movement;
+    uint8_t count;
+};
+bool make_smooth_path(char *raw_path, struct smooth_step *smooth_path,
+                      int size, enum path_language language);
+'''
+
+LANGUAGES = ('PATH_SAFE', 'PATH_DIAGONALS', 'PATH_DIAGONALS_FAST')
+
+
+def compile_path(tmpdir):
+    """
+    Compile the `path.c` module.
+    """
+    builder = FFI()
+    builder.cdef(CDEF)
+    builder.set_source(
+        'benchmark_path',
+        '#include "%s"' % (ROOT / 'path.h'),
+        sources=[str(ROOT / 'path.c')],
+        extra_compile_args=['-O2'])
+    builder.compile(tmpdir=tmpdir)
+    sys.path.insert(0, tmpdir)
+    from benchmark_path import ffi
+    from benchmark_path import lib
+    return ffi, lib
+
+
+def generate_path(length, seed=0):
+    """
+    Generate a random raw path, as found in a maze.
+
+    The path starts and ends with a front movement and never turns three times
+    in a row to the same side, since that would loop over a single cell.
+    """
+    rng = random.Random(seed)
+    path = ['F']
+    while len(path) < length - 1:
+        step = rng.choice('FFLR')
+        if step != 'F' and path[-2:] == [step, step]:
+            continue
+        path.append(step)
+    path.append('F')
+    return 'B' + ''.join(path) + 'S'
+
+
+def benchmark(ffi, lib, path, number=200):
+    """
+    Return the average time, in nanoseconds per raw movement, of each
+    language translation.
+    """
+    source = ffi.new('char[]', path.encode())
+    size = len(path) + 1
+    destination = ffi.new('struct smooth_step[]', size)
+    return {
+        name: timeit.timeit(
+            lambda: lib.make_smooth_path(source, destination, size,
+                                         getattr(lib, name)),
+            number=number) / number / len(path) * 1e9
+        for name in LANGUAGES
+    }
+
+
+def main():
+    with TemporaryDirectory() as tmpdir:
+        ffi, lib = compile_path(tmpdir)
+        results = benchmark(ffi, lib, generate_path(LENGTH))
+    for name in LANGUAGES:
+        print('%-24s%12.1f ns/movement' % (name, results[name]))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,145 @@
+"""
+Benchmark the search planner cost for each supported maze size.
+
+The `search.c` module is compiled on the host once per maze size and the
+flood-fill functions are timed on a random perfect maze with all its walls
+known.
+"""
+from pathlib import Path
+import random
+import sys
+from tempfile import TemporaryDirectory
+import timeit
+
+from cffi import FFI
+
+
+ROOT = Path(__file__).resolve().parent.parent
+
+SIZES = (16, 32)
+
+CDEF = '''
+enum compass_direction { EAST, SOUTH, WEST, NORTH, ... };
+struct walls_around {
+    bool front : 1;
+    bool left : 1;
+    bool right : 1;
+};
+void set_goal_classic(void);
+void set_search_initial_state(void);
+void initialize_maze_walls(void);
+void set_search_state(%(cell)s position, enum compass_direction direction);
+bool update_walls(struct walls_around walls);
+void set_target_goal(void);
+void set_distances_queue(void);
+void set_distances_bitboard(void);
+void set_weighted_distances(void);
+bool set_frontier_targets(void);
+'''
+
+FUNCTIONS = (
+    'set_distances_queue',
+    'set_distances_bitboard',
+    'set_weighted_distances',
+    'set_frontier_targets',
+)
+
+
+def compile_search(size, tmpdir):
+    """
+    Compile the `search.c` module for a given maze size.
+    """
+    builder = FFI()
+    builder.cdef(CDEF % {'cell': 'uint8_t' if size <= 16 else 'uint16_t'})
+    name = 'search%d' % size
+    builder.set_source(
+        name,
+        '#include "%s"' % (ROOT / 'search.h'),
+        sources=[str(ROOT / 'search.c')],
+        define_macros=[('MAZE_SIZE', str(size))],
+        extra_compile_args=['-O2'])
+    builder.compile(tmpdir=tmpdir)
+    sys.path.insert(0, tmpdir)
+    module = __import__(name)
+    return module.ffi, module.lib
+
+
+def generate_maze(size, seed=0):
+    """
+    Generate a random perfect maze, as a set of open passages between cells.
+    """
+    rng = random.Random(seed)
+    passages = set()
+    visited = {(0, 0)}
+    stack = [(0, 0)]
+    while stack:
+        x, y = stack[-1]
+        neighbors = [(x + dx, y + dy) for dx, dy in ((1, 0), (0, 1),
+                                                     (-1, 0), (0, -1))]
+        neighbors = [(nx, ny) for nx, ny in neighbors
+                     if 0 <= nx < size and 0 <= ny < size and
+                     (nx, ny) not in visited]
+        if not neighbors:
+            stack.pop()
+            continue
+        cell = rng.choice(neighbors)
+        passages.add(frozenset(((x, y), cell)))
+        visited.add(cell)
+        stack.append(cell)
+    return passages
+
+
+def load_maze(ffi, lib, size, passages):
+    """
+    Make all the maze walls known to the search module.
+    """
+    def wall(cell, dx, dy):
+        return frozenset((cell, (cell[0] + dx, cell[1] + dy))) not in passages
+
+    lib.set_goal_classic()
+    lib.set_search_initial_state()
+    lib.initialize_maze_walls()
+    for y in range(size):
+        for x in range(size):
+            cell = (x, y)
+            walls = ffi.new('struct walls_around *')
+            lib.set_search_state(y * size + x, lib.NORTH)
+            walls.left = wall(cell, -1, 0)
+            walls.front = wall(cell, 0, 1)
+            walls.right = wall(cell, 1, 0)
+            lib.update_walls(walls[0])
+            lib.set_search_state(y * size + x, lib.SOUTH)
+            walls.left = wall(cell, 1, 0)
+            walls.front = wall(cell, 0, -1)
+            walls.right = wall(cell, -1, 0)
+            lib.update_walls(walls[0])
+    lib.set_search_initial_state()
+    lib.set_target_goal()
+
+
+def benchmark(lib, number=200):
+    """
+    Return the average time, in microseconds, of each planner function.
+    """
+    return {
+        name: timeit.timeit(getattr(lib, name), number=number) / number * 1e6
+        for name in FUNCTIONS
+    }
+
+
+def main():
+    results = {}
+    with TemporaryDirectory() as tmpdir:
+        for size in SIZES:
+            ffi, lib = compile_search(size, tmpdir)
+            load_maze(ffi, lib, size, generate_maze(size))
+            results[size] = benchmark(lib)
+    print('%-24s' % 'us/call' + ''.join('%12s' % ('%dx%d' % (s, s))
+                                        for s in SIZES))
+    for name in FUNCTIONS:
+        print('%-24s' % name + ''.join('%12.1f' % results[s][name]
+                                       for s in SIZES))
+
+
+if __name__ == '__main__':
+    main()
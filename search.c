@@ -1,129 +1,175 @@
 #include "search.h"
 
-static uint8_t distances[MAZE_SIZE * MAZE_SIZE];
-static uint8_t maze_walls[MAZE_SIZE * MAZE_SIZE];
+#define ROW_BIT(x) ((ROW_BITBOARD)1 << (x))
+#define ROW_MASK ((ROW_BITBOARD)(ROW_BIT(MAZE_SIZE - 1) * 2 - 1))
 
-static enum compass_direction initial_direction = NORTH;
-
-static uint8_t current_position;
-static enum compass_direction current_direction;
-
-static struct data_queue {
-	uint8_t buffer[MAZE_AREA];
-	int head;
-	int tail;
-} queue;
-
-struct cells_stack {
-	int cells[MAX_TARGETS];
-	uint8_t size;
-};
+/**
+ * Default maze context, zero-initialized to keep it out of the initialized
+ * data section, and whether its non-zero defaults have been set.
+ */
+static struct maze_context default_maze;
+static bool default_maze_initialized;
 
-static struct cells_stack goal_cells;
-static struct cells_stack target_cells;
+static const enum compass_direction headings[4] = {EAST, SOUTH, WEST,
+						   NORTH};
 
-static void queue_push(uint8_t data)
+static void queue_push(struct maze_context *maze, CELL_INDEX data)
 {
-	queue.buffer[queue.head++] = data;
+	maze->queue.buffer[maze->queue.head++ % MAZE_AREA] = data;
 }
 
-static uint8_t queue_pop(void)
+static CELL_INDEX queue_pop(struct maze_context *maze)
 {
-	return queue.buffer[queue.tail++];
+	return maze->queue.buffer[maze->queue.tail++ % MAZE_AREA];
 }
 
-uint8_t read_cell_distance_value(uint8_t cell)
+CELL_DISTANCE maze_read_cell_distance_value(struct maze_context *maze,
+					    CELL_INDEX cell)
 {
-	return distances[cell];
+	return maze->distances[cell];
 }
 
-uint8_t read_cell_walls_value(uint8_t cell)
+uint8_t maze_read_cell_walls_value(struct maze_context *maze, CELL_INDEX cell)
 {
-	return maze_walls[cell];
+	return maze->maze_walls[cell];
 }
 
 /**
  * @brief Add new goal coordinates.
  */
-void add_goal(int x, int y)
+void maze_add_goal(struct maze_context *maze, int x, int y)
+{
+	maze->goal_cells.cells[maze->goal_cells.size++] = x + y * MAZE_SIZE;
+}
+
+/**
+ * @brief Return whether a cell is one of the goal cells.
+ */
+bool maze_cell_is_goal(struct maze_context *maze, CELL_INDEX cell)
 {
-	goal_cells.cells[goal_cells.size++] = x + y * MAZE_SIZE;
+	int i;
+
+	for (i = 0; i < maze->goal_cells.size; i++)
+		if (maze->goal_cells.cells[i] == cell)
+			return true;
+	return false;
 }
 
 /**
  * @brief Set goal according to the classic micromouse competition rules.
+ *
+ * The goal is the 2x2 square in the center of the maze.
  */
-void set_goal_classic(void)
+void maze_set_goal_classic(struct maze_context *maze)
 {
-	add_goal(7, 7);
-	add_goal(7, 8);
-	add_goal(8, 7);
-	add_goal(8, 8);
+	int center = MAZE_SIZE / 2;
+
+	maze_add_goal(maze, center - 1, center - 1);
+	maze_add_goal(maze, center - 1, center);
+	maze_add_goal(maze, center, center - 1);
+	maze_add_goal(maze, center, center);
 }
 
 /**
  * @brief Add new target cell.
  */
-static void add_target(uint8_t cell)
+static void add_target(struct maze_context *maze, CELL_INDEX cell)
 {
-	target_cells.cells[target_cells.size++] = cell;
+	maze->target_cells.cells[maze->target_cells.size++] = cell;
 }
 
 /**
  * @brief Set new target cell.
  */
-void set_target_cell(uint8_t cell)
+void maze_set_target_cell(struct maze_context *maze, CELL_INDEX cell)
 {
-	target_cells.size = 0;
-	add_target(cell);
+	maze->target_cells.size = 0;
+	add_target(maze, cell);
 }
 
 /**
  * @brief Set the goal as target.
  */
-void set_target_goal(void)
+void maze_set_target_goal(struct maze_context *maze)
 {
 	int i;
 
-	target_cells.size = 0;
-	for (i = 0; i < goal_cells.size; i++)
-		add_target(goal_cells.cells[i]);
+	maze->target_cells.size = 0;
+	for (i = 0; i < maze->goal_cells.size; i++)
+		add_target(maze, maze->goal_cells.cells[i]);
 }
 
-void set_search_initial_direction(enum compass_direction direction)
+void maze_set_search_initial_direction(struct maze_context *maze,
+				       enum compass_direction direction)
 {
-	initial_direction = direction;
+	maze->initial_direction = direction;
 }
 
-void set_search_initial_state(void)
+void maze_set_search_initial_state(struct maze_context *maze)
 {
-	current_position = 0;
-	current_direction = initial_direction;
+	maze->current_position = 0;
+	maze->current_direction = maze->initial_direction;
 }
 
-static enum compass_direction next_compass_direction(enum step_direction step)
+void maze_set_search_state(struct maze_context *maze, CELL_INDEX position,
+			   enum compass_direction direction)
+{
+	maze->current_position = position;
+	maze->current_direction = direction;
+}
+
+/**
+ * @brief Return the compass direction after a step from a given direction.
+ */
+static enum compass_direction rotate_direction(enum compass_direction direction,
+					       enum step_direction step)
 {
 	if (step == LEFT) {
-		if (current_direction == EAST)
+		if (direction == EAST)
 			return NORTH;
-		if (current_direction == SOUTH)
+		if (direction == SOUTH)
 			return EAST;
-		if (current_direction == WEST)
+		if (direction == WEST)
 			return SOUTH;
 		return WEST;
 	}
 	if (step == RIGHT) {
-		if (current_direction == EAST)
+		if (direction == EAST)
 			return SOUTH;
-		if (current_direction == SOUTH)
+		if (direction == SOUTH)
 			return WEST;
-		if (current_direction == WEST)
+		if (direction == WEST)
 			return NORTH;
 		return EAST;
 	}
 	if (step == FRONT)
-		return current_direction;
-	return -current_direction;
+		return direction;
+	return -direction;
+}
+
+static enum compass_direction next_compass_direction(struct maze_context *maze,
+						     enum step_direction step)
+{
+	return rotate_direction(maze->current_direction, step);
+}
+
+/**
+ * @brief Return the wall bit corresponding to a compass direction.
+ */
+static uint8_t direction_wall_bit(enum compass_direction direction)
+{
+	switch (direction) {
+	case EAST:
+		return EAST_BIT;
+	case SOUTH:
+		return SOUTH_BIT;
+	case WEST:
+		return WEST_BIT;
+	case NORTH:
+		return NORTH_BIT;
+	default:
+		return 0;
+	}
 }
 
 /**
@@ -131,67 +177,134 @@ static enum compass_direction next_compass_direction(enum step_direction step)
  *
  * @param[in] side Where to look for the wall.
  */
-bool current_side_wall(enum step_direction side)
+bool maze_current_side_wall(struct maze_context *maze, enum step_direction side)
 {
-	uint8_t bit = 0;
-	enum compass_direction direction;
+	uint8_t bit;
 
-	direction = next_compass_direction(side);
-	switch (direction) {
-	case EAST:
-		bit = EAST_BIT;
+	bit = direction_wall_bit(next_compass_direction(maze, side));
+	return (maze->maze_walls[maze->current_position] & bit);
+}
+
+/**
+ * @brief Return the position after a given step.
+ */
+static CELL_INDEX next_step_position(struct maze_context *maze,
+				     enum step_direction step)
+{
+	return maze->current_position + next_compass_direction(maze, step);
+}
+
+static bool wall_exists(struct maze_context *maze, CELL_INDEX position,
+			uint8_t bit)
+{
+	return (maze->maze_walls[position] & bit);
+}
+
+/**
+ * @brief Set a wall in the row bitboards.
+ *
+ * @param[in] position Cell where the wall is built.
+ * @param[in] bit Wall side in the cell.
+ */
+static void build_wall_bitboard(struct maze_context *maze, CELL_INDEX position,
+				uint8_t bit)
+{
+	int x = position % MAZE_SIZE;
+	int y = position / MAZE_SIZE;
+
+	switch (bit) {
+	case EAST_BIT:
+		maze->east_walls[y] |= ROW_BIT(x);
 		break;
-	case SOUTH:
-		bit = SOUTH_BIT;
+	case SOUTH_BIT:
+		if (y > 0)
+			maze->north_walls[y - 1] |= ROW_BIT(x);
 		break;
-	case WEST:
-		bit = WEST_BIT;
+	case WEST_BIT:
+		if (x > 0)
+			maze->east_walls[y] |= ROW_BIT(x - 1);
 		break;
-	case NORTH:
-		bit = NORTH_BIT;
+	case NORTH_BIT:
+		maze->north_walls[y] |= ROW_BIT(x);
 		break;
 	default:
 		break;
 	}
-	return (maze_walls[current_position] & bit);
 }
 
 /**
- * @brief Return the position after a given step.
+ * @brief Return whether a wall side has been observed.
+ *
+ * @param[in] position Cell position.
+ * @param[in] bit Wall side in the cell.
  */
-static uint8_t next_step_position(enum step_direction step)
+static bool wall_is_known(struct maze_context *maze, CELL_INDEX position,
+			  uint8_t bit)
 {
-	return current_position + next_compass_direction(step);
+	int x = position % MAZE_SIZE;
+	int y = position / MAZE_SIZE;
+
+	switch (bit) {
+	case EAST_BIT:
+		return maze->known_east_walls[y] & ROW_BIT(x);
+	case SOUTH_BIT:
+		return y == 0 || (maze->known_north_walls[y - 1] & ROW_BIT(x));
+	case WEST_BIT:
+		return x == 0 || (maze->known_east_walls[y] & ROW_BIT(x - 1));
+	case NORTH_BIT:
+		return maze->known_north_walls[y] & ROW_BIT(x);
+	default:
+		return false;
+	}
 }
 
-static bool wall_exists(uint8_t position, uint8_t bit)
+/**
+ * @brief Return the sides of a cell which have been observed.
+ *
+ * Uses the same bits as `read_cell_walls_value()`, where a set bit means that
+ * the side has been observed, either open or closed.
+ */
+uint8_t maze_read_cell_known_walls_value(struct maze_context *maze,
+					 CELL_INDEX cell)
 {
-	return (maze_walls[position] & bit);
+	uint8_t known = 0;
+
+	if (wall_is_known(maze, cell, EAST_BIT))
+		known |= EAST_BIT;
+	if (wall_is_known(maze, cell, SOUTH_BIT))
+		known |= SOUTH_BIT;
+	if (wall_is_known(maze, cell, WEST_BIT))
+		known |= WEST_BIT;
+	if (wall_is_known(maze, cell, NORTH_BIT))
+		known |= NORTH_BIT;
+	return known;
 }
 
-static void build_wall(uint8_t position, uint8_t bit)
+static void build_wall(struct maze_context *maze, CELL_INDEX position,
+		       uint8_t bit)
 {
-	maze_walls[position] |= bit;
+	maze->maze_walls[position] |= bit;
+	build_wall_bitboard(maze, position, bit);
 	switch (bit) {
 	case EAST_BIT:
 		if (position % MAZE_SIZE == MAZE_SIZE - 1)
 			break;
-		maze_walls[position + EAST] |= WEST_BIT;
+		maze->maze_walls[position + EAST] |= WEST_BIT;
 		break;
 	case SOUTH_BIT:
 		if (position / MAZE_SIZE == 0)
 			break;
-		maze_walls[position + SOUTH] |= NORTH_BIT;
+		maze->maze_walls[position + SOUTH] |= NORTH_BIT;
 		break;
 	case WEST_BIT:
 		if (position % MAZE_SIZE == 0)
 			break;
-		maze_walls[position + WEST] |= EAST_BIT;
+		maze->maze_walls[position + WEST] |= EAST_BIT;
 		break;
 	case NORTH_BIT:
 		if (position / MAZE_SIZE == MAZE_SIZE - 1)
 			break;
-		maze_walls[position + NORTH] |= SOUTH_BIT;
+		maze->maze_walls[position + NORTH] |= SOUTH_BIT;
 		break;
 	default:
 		break;
@@ -199,26 +312,118 @@ static void build_wall(uint8_t position, uint8_t bit)
 }
 
 /**
- * @brief Place a new wall in the maze memory representation.
+ * @brief Keep track of a cell whose observed walls changed.
  *
- * If the wall was already there, it will do nothing.
+ * The next wall inference is seeded from these cells.
+ */
+static void mark_cell_changed(struct maze_context *maze, CELL_INDEX cell)
+{
+	maze->changed_cells[cell / MAZE_SIZE] |= ROW_BIT(cell % MAZE_SIZE);
+}
+
+/**
+ * @brief Return whether a cell needs no exploration.
  *
- * @return Whether the wall was built or not (i.e.: if it existed before).
+ * That is the case for visited cells and for cells marked by the wall
+ * inference.
  */
-static bool place_wall(uint8_t bit)
+static bool cell_is_explored(struct maze_context *maze, CELL_INDEX cell)
 {
-	if (!wall_exists(current_position, bit)) {
-		build_wall(current_position, bit);
+	if (maze->maze_walls[cell] & VISITED_BIT)
 		return true;
+	return maze->inferred_cells[cell / MAZE_SIZE] &
+	       ROW_BIT(cell % MAZE_SIZE);
+}
+
+/**
+ * @brief Mark all the walls around a cell as observed.
+ *
+ * The cell and its neighbors are tracked for the next wall inference, unless
+ * all the walls were already observed.
+ *
+ * @param[in] position Cell where the walls have been observed.
+ */
+static void mark_walls_known(struct maze_context *maze, CELL_INDEX position)
+{
+	int x = position % MAZE_SIZE;
+	int y = position / MAZE_SIZE;
+	uint8_t all = EAST_BIT | SOUTH_BIT | WEST_BIT | NORTH_BIT;
+
+	if (maze_read_cell_known_walls_value(maze, position) == all)
+		return;
+	mark_cell_changed(maze, position);
+	if (x < MAZE_SIZE - 1)
+		mark_cell_changed(maze, position + EAST);
+	if (y > 0)
+		mark_cell_changed(maze, position + SOUTH);
+	if (x > 0)
+		mark_cell_changed(maze, position + WEST);
+	if (y < MAZE_SIZE - 1)
+		mark_cell_changed(maze, position + NORTH);
+
+	maze->known_east_walls[y] |= ROW_BIT(x);
+	if (x > 0)
+		maze->known_east_walls[y] |= ROW_BIT(x - 1);
+	maze->known_north_walls[y] |= ROW_BIT(x);
+	if (y > 0)
+		maze->known_north_walls[y - 1] |= ROW_BIT(x);
+}
+
+/**
+ * @brief Keep track of a cell next to a newly placed wall.
+ */
+static void add_new_wall_cell(struct maze_context *maze, CELL_INDEX cell)
+{
+	if (maze->new_wall_cells.size == MAX_TARGETS) {
+		maze->new_wall_cells_overflow = true;
+		return;
 	}
-	return false;
+	maze->new_wall_cells.cells[maze->new_wall_cells.size++] = cell;
+}
+
+/**
+ * @brief Place a new wall in the maze memory representation.
+ *
+ * If the wall was already there, it will do nothing. Otherwise the cells at
+ * both sides of the wall are tracked for the next distances update.
+ *
+ * @return Whether the wall was built or not (i.e.: if it existed before).
+ */
+static bool place_wall(struct maze_context *maze, uint8_t bit)
+{
+	enum compass_direction direction = EAST;
+
+	if (wall_exists(maze, maze->current_position, bit))
+		return false;
+	build_wall(maze, maze->current_position, bit);
+	if (bit == SOUTH_BIT)
+		direction = SOUTH;
+	else if (bit == WEST_BIT)
+		direction = WEST;
+	else if (bit == NORTH_BIT)
+		direction = NORTH;
+	add_new_wall_cell(maze, maze->current_position);
+	add_new_wall_cell(maze, maze->current_position + direction);
+	return true;
 }
 
-void update_walls(struct walls_around walls)
+/**
+ * @brief Update the maze walls with the walls around the current position.
+ *
+ * The current cell is marked as visited and all its walls as observed. The
+ * back wall is known not to exist, as that is where the robot came from.
+ *
+ * @param[in] walls Walls around, relative to the current direction.
+ *
+ * @return Whether any new wall was placed in the maze.
+ */
+bool maze_update_walls(struct maze_context *maze, struct walls_around walls)
 {
+	bool placed = false;
+
 	bool windrose[4] = {false, false, false, false};
 
-	switch (current_direction) {
+	switch (maze->current_direction) {
 	case EAST:
 		windrose[0] = walls.front;
 		windrose[1] = walls.right;
@@ -247,44 +452,46 @@ void update_walls(struct walls_around walls)
 		break;
 	}
 	if (windrose[0])
-		place_wall(EAST_BIT);
+		placed |= place_wall(maze, EAST_BIT);
 	if (windrose[1])
-		place_wall(SOUTH_BIT);
+		placed |= place_wall(maze, SOUTH_BIT);
 	if (windrose[2])
-		place_wall(WEST_BIT);
+		placed |= place_wall(maze, WEST_BIT);
 	if (windrose[3])
-		place_wall(NORTH_BIT);
-	maze_walls[current_position] |= VISITED_BIT;
+		placed |= place_wall(maze, NORTH_BIT);
+	maze->maze_walls[maze->current_position] |= VISITED_BIT;
+	mark_walls_known(maze, maze->current_position);
+	return placed;
 }
 
-enum compass_direction search_direction(void)
+enum compass_direction maze_search_direction(struct maze_context *maze)
 {
-	return current_direction;
+	return maze->current_direction;
 }
 
-uint8_t search_position(void)
+CELL_INDEX maze_search_position(struct maze_context *maze)
 {
-	return current_position;
+	return maze->current_position;
 }
 
-uint8_t search_distance(void)
+CELL_DISTANCE maze_search_distance(struct maze_context *maze)
 {
-	return distances[current_position];
+	return maze->distances[maze->current_position];
 }
 
-static uint8_t left_distance(void)
+static CELL_DISTANCE left_distance(struct maze_context *maze)
 {
-	return distances[next_step_position(LEFT)];
+	return maze->distances[next_step_position(maze, LEFT)];
 }
 
-static uint8_t front_distance(void)
+static CELL_DISTANCE front_distance(struct maze_context *maze)
 {
-	return distances[next_step_position(FRONT)];
+	return maze->distances[next_step_position(maze, FRONT)];
 }
 
-static uint8_t right_distance(void)
+static CELL_DISTANCE right_distance(struct maze_context *maze)
 {
-	return distances[next_step_position(RIGHT)];
+	return maze->distances[next_step_position(maze, RIGHT)];
 }
 
 /**
@@ -292,56 +499,139 @@ static uint8_t right_distance(void)
  *
  * Basically add walls to the maze perimeter.
  */
-void initialize_maze_walls(void)
+void maze_initialize_maze_walls(struct maze_context *maze)
 {
 	int i;
 
 	for (i = 0; i < MAZE_SIZE * MAZE_SIZE; i++)
-		maze_walls[i] = 0;
+		maze->maze_walls[i] = 0;
+
+	for (i = 0; i < MAZE_SIZE; i++) {
+		maze->maze_walls[MAZE_SIZE - 1 + i * MAZE_SIZE] |= EAST_BIT;
+		maze->maze_walls[i] |= SOUTH_BIT;
+		maze->maze_walls[i * MAZE_SIZE] |= WEST_BIT;
+		maze->maze_walls[i + (MAZE_SIZE - 1) * MAZE_SIZE] |= NORTH_BIT;
+	}
+
+	for (i = 0; i < MAZE_SIZE; i++) {
+		maze->east_walls[i] = ROW_BIT(MAZE_SIZE - 1);
+		maze->north_walls[i] = 0;
+		maze->known_east_walls[i] = maze->east_walls[i];
+		maze->known_north_walls[i] = 0;
+	}
+	maze->north_walls[MAZE_SIZE - 1] = ROW_MASK;
+	maze->known_north_walls[MAZE_SIZE - 1] = ROW_MASK;
 
 	for (i = 0; i < MAZE_SIZE; i++) {
-		maze_walls[MAZE_SIZE - 1 + i * MAZE_SIZE] |= EAST_BIT;
-		maze_walls[i] |= SOUTH_BIT;
-		maze_walls[i * MAZE_SIZE] |= WEST_BIT;
-		maze_walls[i + (MAZE_SIZE - 1) * MAZE_SIZE] |= NORTH_BIT;
+		maze->filled_cells[i] = 0;
+		maze->inferred_cells[i] = 0;
+		maze->changed_cells[i] = ROW_MASK;
 	}
+	maze->inference_stats = (struct inference_stats){0};
 }
 
-enum step_direction best_neighbor_step(struct walls_around walls)
+/**
+ * @brief Copy the walls, observed walls and visited cells to a snapshot.
+ */
+void maze_take_walls_snapshot(struct maze_context *maze,
+			      struct walls_snapshot *snapshot)
+{
+	int i;
+
+	for (i = 0; i < MAZE_SIZE; i++) {
+		snapshot->east_walls[i] = maze->east_walls[i];
+		snapshot->north_walls[i] = maze->north_walls[i];
+		snapshot->known_east_walls[i] = maze->known_east_walls[i];
+		snapshot->known_north_walls[i] = maze->known_north_walls[i];
+		snapshot->visited_cells[i] = 0;
+	}
+	for (i = 0; i < MAZE_AREA; i++)
+		if (maze->maze_walls[i] & VISITED_BIT)
+			snapshot->visited_cells[i / MAZE_SIZE] |=
+			    ROW_BIT(i % MAZE_SIZE);
+}
+
+/**
+ * @brief Replace the walls, observed walls and visited cells with a snapshot.
+ *
+ * The wall inference state is reset, so that the next inference evaluates the
+ * whole maze, and the next distances update will be a full flood fill.
+ */
+void maze_restore_walls_snapshot(struct maze_context *maze,
+				 const struct walls_snapshot *snapshot)
+{
+	int i;
+	int x;
+	int y;
+	uint8_t walls;
+
+	for (i = 0; i < MAZE_SIZE; i++) {
+		maze->east_walls[i] = snapshot->east_walls[i];
+		maze->north_walls[i] = snapshot->north_walls[i];
+		maze->known_east_walls[i] = snapshot->known_east_walls[i];
+		maze->known_north_walls[i] = snapshot->known_north_walls[i];
+		maze->filled_cells[i] = 0;
+		maze->inferred_cells[i] = 0;
+		maze->changed_cells[i] = ROW_MASK;
+	}
+	for (i = 0; i < MAZE_AREA; i++) {
+		x = i % MAZE_SIZE;
+		y = i / MAZE_SIZE;
+		walls = 0;
+		if (snapshot->visited_cells[y] & ROW_BIT(x))
+			walls |= VISITED_BIT;
+		if (snapshot->east_walls[y] & ROW_BIT(x))
+			walls |= EAST_BIT;
+		if (y == 0 || (snapshot->north_walls[y - 1] & ROW_BIT(x)))
+			walls |= SOUTH_BIT;
+		if (x == 0 || (snapshot->east_walls[y] & ROW_BIT(x - 1)))
+			walls |= WEST_BIT;
+		if (snapshot->north_walls[y] & ROW_BIT(x))
+			walls |= NORTH_BIT;
+		maze->maze_walls[i] = walls;
+	}
+	maze->inference_stats = (struct inference_stats){0};
+	maze->new_wall_cells.size = 0;
+	maze->new_wall_cells_overflow = true;
+}
+
+enum step_direction maze_best_neighbor_step(struct maze_context *maze,
+					    struct walls_around walls)
 {
-	if (!walls.front && (front_distance() < search_distance()))
+	if (!walls.front && (front_distance(maze) < maze_search_distance(maze)))
 		return FRONT;
-	if (!walls.left && (left_distance() < search_distance()))
+	if (!walls.left && (left_distance(maze) < maze_search_distance(maze)))
 		return LEFT;
-	if (!walls.right && (right_distance() < search_distance()))
+	if (!walls.right && (right_distance(maze) < maze_search_distance(maze)))
 		return RIGHT;
 	return BACK;
 }
 
-static void queue_push_breath(uint8_t cell, uint8_t distance)
+static void queue_push_breath(struct maze_context *maze, CELL_INDEX cell,
+			      CELL_DISTANCE distance)
 {
-	if (distances[cell] <= distance)
+	if (maze->distances[cell] <= distance)
 		return;
-	distances[cell] = distance;
-	queue_push(cell);
+	maze->distances[cell] = distance;
+	queue_push(maze, cell);
 }
 
-static void update_distances_breath(void)
+static void update_distances_breath(struct maze_context *maze)
 {
-	uint8_t cell;
-	uint8_t distance;
+	CELL_INDEX cell;
+	CELL_DISTANCE distance;
 
-	while (queue.head != queue.tail) {
-		cell = queue_pop();
-		distance = distances[cell] + 1;
-		if (!wall_exists(cell, EAST_BIT))
-			queue_push_breath(cell + EAST, distance);
-		if (!wall_exists(cell, SOUTH_BIT))
-			queue_push_breath(cell + SOUTH, distance);
-		if (!wall_exists(cell, WEST_BIT))
-			queue_push_breath(cell + WEST, distance);
-		if (!wall_exists(cell, NORTH_BIT))
-			queue_push_breath(cell + NORTH, distance);
+	while (maze->queue.head != maze->queue.tail) {
+		cell = queue_pop(maze);
+		distance = maze->distances[cell] + 1;
+		if (!wall_exists(maze, cell, EAST_BIT))
+			queue_push_breath(maze, cell + EAST, distance);
+		if (!wall_exists(maze, cell, SOUTH_BIT))
+			queue_push_breath(maze, cell + SOUTH, distance);
+		if (!wall_exists(maze, cell, WEST_BIT))
+			queue_push_breath(maze, cell + WEST, distance);
+		if (!wall_exists(maze, cell, NORTH_BIT))
+			queue_push_breath(maze, cell + NORTH, distance);
 	}
 }
 
@@ -351,115 +641,1477 @@ static void update_distances_breath(void)
  * To be executed as the first flood-fill step, before pushing the target
  * cells to the queue.
  */
-static void _reset_distances_and_queue(void)
+static void _reset_distances_and_queue(struct maze_context *maze)
 {
 	int i;
 
 	for (i = 0; i < MAZE_AREA; i++)
-		distances[i] = MAX_DISTANCE;
-	queue.head = 0;
-	queue.tail = 0;
+		maze->distances[i] = MAX_DISTANCE;
+	maze->queue.head = 0;
+	maze->queue.tail = 0;
 }
 
 /**
- * @brief Set maze distances with respect to the target.
+ * @brief Set maze distances with respect to the target using a cell queue.
+ *
+ * Classic breadth-first flood fill, checking the four walls of each cell.
  */
-void set_distances(void)
+void maze_set_distances_queue(struct maze_context *maze)
 {
 	int i;
 	int cell;
 
-	_reset_distances_and_queue();
-	for (i = 0; i < target_cells.size; i++) {
-		cell = target_cells.cells[i];
-		distances[cell] = 0;
-		queue_push(cell);
+	_reset_distances_and_queue(maze);
+	for (i = 0; i < maze->target_cells.size; i++) {
+		cell = maze->target_cells.cells[i];
+		maze->distances[cell] = 0;
+		queue_push(maze, cell);
 	}
-	update_distances_breath();
+	update_distances_breath(maze);
 }
 
-void move_search_position(enum step_direction step)
+/**
+ * @brief Write the distance of all the cells set in a row bitmask.
+ *
+ * @param[out] output Distances array to write to.
+ * @param[in] row Row index.
+ * @param[in] cells Bitmask of the cells in the row.
+ * @param[in] distance Distance to write.
+ */
+static void write_row_distances(CELL_DISTANCE *output, int row,
+				ROW_BITBOARD cells, CELL_DISTANCE distance)
 {
-	enum compass_direction next;
+	CELL_DISTANCE *row_distances = &output[row * MAZE_SIZE];
 
-	next = next_compass_direction(step);
-	current_position += next;
-	current_direction = next;
+	while (cells) {
+		row_distances[__builtin_ctz(cells)] = distance;
+		cells &= (ROW_BITBOARD)(cells - 1);
+	}
 }
 
 /**
- * @brief Return whether the current cell has already been visited before.
+ * @brief Flood fill the maze from a set of cells using row bitboards.
+ *
+ * Each distance wavefront is expanded for all the cells of a row at once:
+ *
+ * - East moves are the front shifted left, masked by the east walls.
+ * - West moves are the front shifted right, masked by the neighbor east walls.
+ * - North and south moves are masked by the north walls of the row below.
+ *
+ * Only rows with a non-empty front, and their neighbors, are processed on
+ * each wave, so the cost is proportional to the wavefront size. Rows are
+ * processed upwards in place, keeping the previous front of the row below.
+ * When the row below was not processed its front is empty, and so is the
+ * front of the last processed row, which is always a non-active neighbor.
+ *
+ * @param[in] east Row bitmasks of the east walls.
+ * @param[in] north Row bitmasks of the north walls.
+ * @param[in] sources Cells to flood from.
+ * @param[out] output Distances array to write, or NULL to only measure.
+ * @param[in] cell Cell to measure the distance to.
+ *
+ * @return The distance from the sources to the measured cell. If no output
+ * is provided, the flood stops as soon as the measured cell is reached.
  */
-bool current_cell_is_visited(void)
+static CELL_DISTANCE flood_bitboard(const ROW_BITBOARD *east,
+				    const ROW_BITBOARD *north,
+				    struct cells_stack *sources,
+				    CELL_DISTANCE *output, CELL_INDEX cell)
 {
-	return (bool)(maze_walls[current_position] & VISITED_BIT);
+	int i;
+	int row;
+	int cell_row = cell / MAZE_SIZE;
+	ROW_BITBOARD cell_bit = ROW_BIT(cell % MAZE_SIZE);
+	CELL_DISTANCE distance = 0;
+	ROW_BITBOARD moves;
+	ROW_BITBOARD rows;
+	ROW_BITBOARD current;
+	ROW_BITBOARD previous;
+	ROW_BITBOARD active = 0;
+	ROW_BITBOARD reached[MAZE_SIZE] = {0};
+	ROW_BITBOARD front[MAZE_SIZE] = {0};
+
+	for (i = 0; i < sources->size; i++) {
+		row = sources->cells[i] / MAZE_SIZE;
+		front[row] |= ROW_BIT(sources->cells[i] % MAZE_SIZE);
+		active |= ROW_BIT(row);
+	}
+	if (output) {
+		for (i = 0; i < MAZE_AREA; i++)
+			output[i] = MAX_DISTANCE;
+		for (row = 0; row < MAZE_SIZE; row++)
+			write_row_distances(output, row, front[row], distance);
+	}
+	for (row = 0; row < MAZE_SIZE; row++)
+		reached[row] = front[row];
+
+	while (active) {
+		if (!output && (reached[cell_row] & cell_bit))
+			return distance;
+		distance++;
+		rows = (ROW_BITBOARD)(active | (active << 1) | (active >> 1)) &
+		       ROW_MASK;
+		active = 0;
+		previous = 0;
+		for (; rows; rows &= rows - 1) {
+			row = __builtin_ctz(rows);
+			current = front[row];
+			moves = (ROW_BITBOARD)((current & ~east[row]) << 1);
+			moves |= (ROW_BITBOARD)(current >> 1) & ~east[row];
+			if (row > 0)
+				moves |= previous & ~north[row - 1];
+			if (row < MAZE_SIZE - 1)
+				moves |= front[row + 1] & ~north[row];
+			moves &= ~reached[row];
+			previous = current;
+			front[row] = moves;
+			if (!moves)
+				continue;
+			reached[row] |= moves;
+			active |= ROW_BIT(row);
+			if (output)
+				write_row_distances(output, row, moves,
+						    distance);
+		}
+	}
+	if (output)
+		return output[cell];
+	return MAX_DISTANCE;
 }
 
 /**
- * @brief Return the walls around at the current position.
+ * @brief Set maze distances with respect to the target using row bitboards.
  */
-struct walls_around current_walls_around(void)
+void maze_set_distances_bitboard(struct maze_context *maze)
 {
-	struct walls_around walls;
-	uint8_t cell;
+	flood_bitboard(maze->east_walls, maze->north_walls, &maze->target_cells,
+		       maze->distances, 0);
+}
 
-	cell = maze_walls[current_position];
-	switch (current_direction) {
-	case EAST:
-		walls.left = (bool)(cell & NORTH_BIT);
-		walls.front = (bool)(cell & EAST_BIT);
-		walls.right = (bool)(cell & SOUTH_BIT);
-		break;
-	case SOUTH:
-		walls.left = (bool)(cell & EAST_BIT);
-		walls.front = (bool)(cell & SOUTH_BIT);
-		walls.right = (bool)(cell & WEST_BIT);
-		break;
-	case WEST:
-		walls.left = (bool)(cell & SOUTH_BIT);
-		walls.front = (bool)(cell & WEST_BIT);
-		walls.right = (bool)(cell & NORTH_BIT);
-		break;
-	case NORTH:
-		walls.left = (bool)(cell & WEST_BIT);
-		walls.front = (bool)(cell & NORTH_BIT);
-		walls.right = (bool)(cell & EAST_BIT);
-		break;
-	default:
-		break;
+/**
+ * @brief Build the pessimistic walls, where unknown walls are considered.
+ *
+ * @param[out] east Row bitmasks of the pessimistic east walls.
+ * @param[out] north Row bitmasks of the pessimistic north walls.
+ */
+static void build_pessimistic_walls(struct maze_context *maze,
+				    ROW_BITBOARD *east, ROW_BITBOARD *north)
+{
+	int row;
+
+	for (row = 0; row < MAZE_SIZE; row++) {
+		east[row] = maze->east_walls[row] |
+			    (ROW_BITBOARD)~maze->known_east_walls[row];
+		north[row] =
+		    maze->north_walls[row] |
+		    (ROW_BITBOARD)~maze->known_north_walls[row];
 	}
+}
 
-	return walls;
+/**
+ * @brief Set pessimistic maze distances with respect to the target.
+ *
+ * Walls that have not been observed yet are considered to exist, so the
+ * distances are only through known paths. Always uses row bitboards.
+ */
+void maze_set_distances_pessimistic(struct maze_context *maze)
+{
+	ROW_BITBOARD east[MAZE_SIZE];
+	ROW_BITBOARD north[MAZE_SIZE];
+
+	build_pessimistic_walls(maze, east, north);
+	flood_bitboard(east, north, &maze->target_cells, maze->distances, 0);
 }
 
 /**
- * @brief Find an unexplored and potentially interesting cell.
+ * @brief Return whether an optimal path from the start to the goal is known.
+ *
+ * That is the case when the optimistic start-to-goal distance (considering
+ * unknown walls do not exist) is equal to the pessimistic one (considering
+ * unknown walls exist). Then no unexplored cell can shorten the known path.
+ *
+ * Distances and targets are not modified.
  */
-uint8_t find_unexplored_interesting_cell(void)
-{
-	uint8_t interesting = 0;
-	uint8_t backed_up_position;
-	enum compass_direction backed_up_direction;
-	enum step_direction step;
-
-	/* Back up position and direction */
-	backed_up_position = current_position;
-	backed_up_direction = current_direction;
-
-	set_search_initial_state();
-	set_target_goal();
-	set_distances();
-	while (search_distance() > 0) {
-		step = best_neighbor_step(current_walls_around());
-		move_search_position(step);
-		if (!current_cell_is_visited()) {
-			interesting = current_position;
-			break;
-		}
-	}
+bool maze_optimal_path_is_known(struct maze_context *maze)
+{
+	CELL_DISTANCE optimistic;
+	CELL_DISTANCE pessimistic;
+	ROW_BITBOARD east[MAZE_SIZE];
+	ROW_BITBOARD north[MAZE_SIZE];
+
+	optimistic =
+	    flood_bitboard(maze->east_walls, maze->north_walls,
+			   &maze->goal_cells, NULL, 0);
+	build_pessimistic_walls(maze, east, north);
+	pessimistic = flood_bitboard(east, north, &maze->goal_cells, NULL, 0);
+	return pessimistic == optimistic;
+}
+
+/**
+ * @brief Set maze distances with respect to the target.
+ *
+ * The flood-fill engine is selected at compile time with
+ * `SEARCH_FLOOD_ENGINE`.
+ */
+void maze_set_distances(struct maze_context *maze)
+{
+	maze->new_wall_cells.size = 0;
+	maze->new_wall_cells_overflow = false;
+#if SEARCH_FLOOD_ENGINE == SEARCH_FLOOD_BITBOARD
+	maze_set_distances_bitboard(maze);
+#else
+	maze_set_distances_queue(maze);
+#endif
+}
+
+static bool cell_is_queued(struct maze_context *maze, CELL_INDEX cell)
+{
+	return maze->queued_cells[cell / MAZE_SIZE] & ROW_BIT(cell % MAZE_SIZE);
+}
+
+static void set_cell_queued(struct maze_context *maze, CELL_INDEX cell,
+			    bool queued)
+{
+	if (queued)
+		maze->queued_cells[cell / MAZE_SIZE] |=
+		    ROW_BIT(cell % MAZE_SIZE);
+	else
+		maze->queued_cells[cell / MAZE_SIZE] &=
+		    (ROW_BITBOARD)~ROW_BIT(cell % MAZE_SIZE);
+}
+
+/**
+ * @brief Return the lowest distance among the accessible neighbors of a cell.
+ */
+static CELL_DISTANCE lowest_neighbor_distance(struct maze_context *maze,
+					      CELL_INDEX cell)
+{
+	CELL_DISTANCE lowest = MAX_DISTANCE;
+	CELL_DISTANCE *distances = maze->distances;
+
+	if (!wall_exists(maze, cell, EAST_BIT) &&
+	    distances[cell + EAST] < lowest)
+		lowest = distances[cell + EAST];
+	if (!wall_exists(maze, cell, SOUTH_BIT) &&
+	    distances[cell + SOUTH] < lowest)
+		lowest = distances[cell + SOUTH];
+	if (!wall_exists(maze, cell, WEST_BIT) &&
+	    distances[cell + WEST] < lowest)
+		lowest = distances[cell + WEST];
+	if (!wall_exists(maze, cell, NORTH_BIT) &&
+	    distances[cell + NORTH] < lowest)
+		lowest = distances[cell + NORTH];
+	return lowest;
+}
 
-	/* Recover backed up position and direction */
-	current_position = backed_up_position;
-	current_direction = backed_up_direction;
-	return interesting;
+/**
+ * @brief Return whether a cell distance is still supported by a neighbor.
+ *
+ * A cell is supported when it is a target or when it has an accessible
+ * neighbor which is one step closer to the target.
+ */
+static bool cell_distance_is_supported(struct maze_context *maze,
+				       CELL_INDEX cell)
+{
+	if (maze->distances[cell] == 0)
+		return true;
+	return lowest_neighbor_distance(maze, cell) ==
+	       maze->distances[cell] - 1;
+}
+
+/**
+ * @brief Raise the distance of a cell if it lost its support.
+ *
+ * Raised cells are set to `MAX_DISTANCE` and pushed to the queue.
+ */
+static void raise_unsupported_cell(struct maze_context *maze, CELL_INDEX cell)
+{
+	if (maze->distances[cell] == MAX_DISTANCE)
+		return;
+	if (cell_distance_is_supported(maze, cell))
+		return;
+	maze->distances[cell] = MAX_DISTANCE;
+	queue_push(maze, cell);
+}
+
+/**
+ * @brief Lower the distance of a cell neighbor, queuing it if it improved.
+ */
+static void lower_neighbor_distance(struct maze_context *maze, CELL_INDEX cell,
+				    CELL_DISTANCE distance)
+{
+	if (maze->distances[cell] <= distance)
+		return;
+	maze->distances[cell] = distance;
+	if (cell_is_queued(maze, cell))
+		return;
+	set_cell_queued(maze, cell, true);
+	queue_push(maze, cell);
+}
+
+/**
+ * @brief Update maze distances after placing new walls.
+ *
+ * Assumes distances were consistent with the walls before those were placed.
+ * Walls can only make distances grow, so the update is done in two steps:
+ *
+ * - Raise: cells that lost their support are set to `MAX_DISTANCE`, and so
+ *   are, recursively, the neighbors that depended on them.
+ * - Lower: raised cells get their distance from their neighbors and improved
+ *   cells propagate their new distance until no cell improves.
+ *
+ * Only cells whose distance may change are processed, and no work is done at
+ * all if no new walls were placed since the last update.
+ */
+void maze_update_distances(struct maze_context *maze)
+{
+	int i;
+	int raised;
+	CELL_INDEX cell;
+	CELL_DISTANCE lowest;
+	CELL_DISTANCE distance;
+
+	if (maze->new_wall_cells_overflow) {
+		maze_set_distances(maze);
+		return;
+	}
+	if (!maze->new_wall_cells.size)
+		return;
+
+	maze->queue.head = 0;
+	maze->queue.tail = 0;
+	for (i = 0; i < maze->new_wall_cells.size; i++)
+		raise_unsupported_cell(maze, maze->new_wall_cells.cells[i]);
+	maze->new_wall_cells.size = 0;
+	while (maze->queue.head != maze->queue.tail) {
+		cell = queue_pop(maze);
+		if (!wall_exists(maze, cell, EAST_BIT))
+			raise_unsupported_cell(maze, cell + EAST);
+		if (!wall_exists(maze, cell, SOUTH_BIT))
+			raise_unsupported_cell(maze, cell + SOUTH);
+		if (!wall_exists(maze, cell, WEST_BIT))
+			raise_unsupported_cell(maze, cell + WEST);
+		if (!wall_exists(maze, cell, NORTH_BIT))
+			raise_unsupported_cell(maze, cell + NORTH);
+	}
+
+	raised = maze->queue.head;
+	maze->queue.tail = 0;
+	for (i = 0; i < raised; i++) {
+		cell = maze->queue.buffer[i];
+		set_cell_queued(maze, cell, true);
+		lowest = lowest_neighbor_distance(maze, cell);
+		if (lowest < MAX_DISTANCE)
+			maze->distances[cell] = lowest + 1;
+	}
+	while (maze->queue.head != maze->queue.tail) {
+		cell = queue_pop(maze);
+		set_cell_queued(maze, cell, false);
+		if (maze->distances[cell] == MAX_DISTANCE)
+			continue;
+		distance = maze->distances[cell] + 1;
+		if (!wall_exists(maze, cell, EAST_BIT))
+			lower_neighbor_distance(maze, cell + EAST, distance);
+		if (!wall_exists(maze, cell, SOUTH_BIT))
+			lower_neighbor_distance(maze, cell + SOUTH, distance);
+		if (!wall_exists(maze, cell, WEST_BIT))
+			lower_neighbor_distance(maze, cell + WEST, distance);
+		if (!wall_exists(maze, cell, NORTH_BIT))
+			lower_neighbor_distance(maze, cell + NORTH, distance);
+	}
+}
+
+void maze_move_search_position(struct maze_context *maze,
+			       enum step_direction step)
+{
+	enum compass_direction next;
+
+	next = next_compass_direction(maze, step);
+	maze->current_position += next;
+	maze->current_direction = next;
+}
+
+/**
+ * @brief Return whether the current cell has already been visited before.
+ */
+bool maze_current_cell_is_visited(struct maze_context *maze)
+{
+	return (bool)(maze->maze_walls[maze->current_position] & VISITED_BIT);
+}
+
+/**
+ * @brief Return the walls around at the current position.
+ */
+struct walls_around maze_current_walls_around(struct maze_context *maze)
+{
+	struct walls_around walls;
+	CELL_INDEX cell;
+
+	cell = maze->maze_walls[maze->current_position];
+	switch (maze->current_direction) {
+	case EAST:
+		walls.left = (bool)(cell & NORTH_BIT);
+		walls.front = (bool)(cell & EAST_BIT);
+		walls.right = (bool)(cell & SOUTH_BIT);
+		break;
+	case SOUTH:
+		walls.left = (bool)(cell & EAST_BIT);
+		walls.front = (bool)(cell & SOUTH_BIT);
+		walls.right = (bool)(cell & WEST_BIT);
+		break;
+	case WEST:
+		walls.left = (bool)(cell & SOUTH_BIT);
+		walls.front = (bool)(cell & WEST_BIT);
+		walls.right = (bool)(cell & NORTH_BIT);
+		break;
+	case NORTH:
+		walls.left = (bool)(cell & WEST_BIT);
+		walls.front = (bool)(cell & NORTH_BIT);
+		walls.right = (bool)(cell & EAST_BIT);
+		break;
+	default:
+		break;
+	}
+
+	return walls;
+}
+
+/**
+ * @brief Return the walls around at the current position, pessimistically.
+ *
+ * Walls that have not been observed yet are considered to exist.
+ */
+struct walls_around
+maze_current_walls_around_pessimistic(struct maze_context *maze)
+{
+	struct walls_around walls;
+	CELL_INDEX cell = maze->current_position;
+	enum compass_direction left = next_compass_direction(maze, LEFT);
+	enum compass_direction front = next_compass_direction(maze, FRONT);
+	enum compass_direction right = next_compass_direction(maze, RIGHT);
+
+	walls = maze_current_walls_around(maze);
+	if (!wall_is_known(maze, cell, direction_wall_bit(left)))
+		walls.left = true;
+	if (!wall_is_known(maze, cell, direction_wall_bit(front)))
+		walls.front = true;
+	if (!wall_is_known(maze, cell, direction_wall_bit(right)))
+		walls.right = true;
+	return walls;
+}
+
+/**
+ * @brief Mark a single wall side as observed.
+ *
+ * When the side was not observed yet, the cells on both sides are tracked for
+ * the next wall inference. Border walls are always observed, so the neighbor
+ * across an unobserved side always exists.
+ *
+ * @param[in] position Cell position.
+ * @param[in] bit Wall side in the cell.
+ */
+static void mark_wall_known(struct maze_context *maze, CELL_INDEX position,
+			    uint8_t bit)
+{
+	int x = position % MAZE_SIZE;
+	int y = position / MAZE_SIZE;
+
+	if (wall_is_known(maze, position, bit))
+		return;
+	mark_cell_changed(maze, position);
+	if (bit == EAST_BIT) {
+		maze->known_east_walls[y] |= ROW_BIT(x);
+		mark_cell_changed(maze, position + EAST);
+	} else if (bit == WEST_BIT) {
+		maze->known_east_walls[y] |= ROW_BIT(x - 1);
+		mark_cell_changed(maze, position + WEST);
+	} else if (bit == NORTH_BIT) {
+		maze->known_north_walls[y] |= ROW_BIT(x);
+		mark_cell_changed(maze, position + NORTH);
+	} else if (bit == SOUTH_BIT) {
+		maze->known_north_walls[y - 1] |= ROW_BIT(x);
+		mark_cell_changed(maze, position + SOUTH);
+	}
+}
+
+/**
+ * @brief Set the state of a wall deduced without observing it.
+ *
+ * New walls are tracked for the next distances update, like observed ones.
+ *
+ * @param[in] position Cell position.
+ * @param[in] bit Wall side in the cell.
+ * @param[in] exists Whether the wall exists or not.
+ *
+ * @return Whether a new wall was built.
+ */
+static bool infer_wall(struct maze_context *maze, CELL_INDEX position,
+		       uint8_t bit, bool exists)
+{
+	bool placed = exists && !wall_exists(maze, position, bit);
+
+	mark_wall_known(maze, position, bit);
+	if (!placed)
+		return false;
+	build_wall(maze, position, bit);
+	add_new_wall_cell(maze, position);
+	if (bit == EAST_BIT)
+		add_new_wall_cell(maze, position + EAST);
+	else if (bit == SOUTH_BIT)
+		add_new_wall_cell(maze, position + SOUTH);
+	else if (bit == WEST_BIT)
+		add_new_wall_cell(maze, position + WEST);
+	else
+		add_new_wall_cell(maze, position + NORTH);
+	return true;
+}
+
+/**
+ * @brief Return whether a wall side is known to be open.
+ */
+static bool wall_is_known_open(struct maze_context *maze, CELL_INDEX position,
+			       uint8_t bit)
+{
+	return wall_is_known(maze, position, bit) &&
+	       !wall_exists(maze, position, bit);
+}
+
+/**
+ * @brief Remove and return the lowest cell of a set of row bitboards.
+ *
+ * @param[in, out] cells Row bitboards of the set.
+ *
+ * @return The removed cell, or -1 if the set is empty.
+ */
+static int pop_cell(ROW_BITBOARD *cells)
+{
+	int y;
+	int x;
+
+	for (y = 0; y < MAZE_SIZE; y++) {
+		if (!cells[y])
+			continue;
+		x = __builtin_ctz(cells[y]);
+		cells[y] &= (ROW_BITBOARD)(cells[y] - 1);
+		return y * MAZE_SIZE + x;
+	}
+	return -1;
+}
+
+/**
+ * @brief Mark the changed cells with all their walls observed as inferred.
+ *
+ * @return The number of cells marked.
+ */
+static uint16_t mark_determined_cells(struct maze_context *maze)
+{
+	int y;
+	int cell;
+	ROW_BITBOARD cells;
+	uint16_t marked = 0;
+	uint8_t all = EAST_BIT | SOUTH_BIT | WEST_BIT | NORTH_BIT;
+
+	for (y = 0; y < MAZE_SIZE; y++) {
+		cells = maze->changed_cells[y] & ~maze->inferred_cells[y];
+		for (; cells; cells &= (ROW_BITBOARD)(cells - 1)) {
+			cell = y * MAZE_SIZE + __builtin_ctz(cells);
+			if (maze->maze_walls[cell] & VISITED_BIT)
+				continue;
+			if (maze_read_cell_known_walls_value(maze, cell) != all)
+				continue;
+			maze->inferred_cells[y] |= ROW_BIT(cell % MAZE_SIZE);
+			marked++;
+		}
+	}
+	return marked;
+}
+
+/**
+ * @brief Deduce the walls of the start cell.
+ *
+ * The start cell is open only towards the initial direction, which must be
+ * either north or east.
+ *
+ * @return Whether any new wall was placed in the maze.
+ */
+static bool infer_start_walls(struct maze_context *maze)
+{
+	if (maze->initial_direction == NORTH)
+		return infer_wall(maze, 0, EAST_BIT, true) |
+		       infer_wall(maze, 0, NORTH_BIT, false);
+	return infer_wall(maze, 0, NORTH_BIT, true) |
+	       infer_wall(maze, 0, EAST_BIT, false);
+}
+
+/**
+ * @brief Deduce the missing wall around an interior post, if possible.
+ *
+ * When three of the walls around the post are known not to exist, the fourth
+ * one must exist. Posts surrounded by goal cells are skipped, as the goal area
+ * may have no walls inside.
+ *
+ * @param[in] x Post column, with post `(x, y)` at the south-west corner of
+ * cell `(x, y)`.
+ * @param[in] y Post row.
+ *
+ * @return Whether any new wall was placed in the maze.
+ */
+static bool infer_post(struct maze_context *maze, int x, int y)
+{
+	int open;
+	CELL_INDEX cells[4];
+	uint8_t bits[4] = {EAST_BIT, EAST_BIT, NORTH_BIT, NORTH_BIT};
+	bool placed = false;
+
+	if (x < 1 || x >= MAZE_SIZE || y < 1 || y >= MAZE_SIZE)
+		return false;
+	/* Walls below, above, left and right of the post */
+	cells[0] = (y - 1) * MAZE_SIZE + x - 1;
+	cells[1] = y * MAZE_SIZE + x - 1;
+	cells[2] = cells[0];
+	cells[3] = cells[0] + EAST;
+	if (maze_cell_is_goal(maze, cells[0]) &&
+	    maze_cell_is_goal(maze, cells[1]) &&
+	    maze_cell_is_goal(maze, cells[3]) &&
+	    maze_cell_is_goal(maze, cells[1] + EAST))
+		return false;
+	open = 0;
+	open += wall_is_known_open(maze, cells[0], bits[0]);
+	open += wall_is_known_open(maze, cells[1], bits[1]);
+	open += wall_is_known_open(maze, cells[2], bits[2]);
+	open += wall_is_known_open(maze, cells[3], bits[3]);
+	if (open != 3)
+		return false;
+	for (open = 0; open < 4; open++)
+		if (!wall_is_known(maze, cells[open], bits[open]))
+			placed |= infer_wall(maze, cells[open], bits[open],
+					     true);
+	return placed;
+}
+
+/**
+ * @brief Deduce walls from the rule that every post has at least one wall.
+ *
+ * Only the posts at the corners of the changed cells are evaluated. Deduced
+ * walls change more cells, whose posts are evaluated too.
+ *
+ * @return Whether any new wall was placed in the maze.
+ */
+static bool infer_post_walls(struct maze_context *maze)
+{
+	int y;
+	int cell;
+	ROW_BITBOARD pending[MAZE_SIZE];
+	ROW_BITBOARD checked[MAZE_SIZE] = {0};
+	ROW_BITBOARD found = 1;
+	bool placed = false;
+
+	while (found) {
+		found = 0;
+		for (y = 0; y < MAZE_SIZE; y++) {
+			pending[y] = maze->changed_cells[y] & ~checked[y];
+			checked[y] |= pending[y];
+			found |= pending[y];
+		}
+		while ((cell = pop_cell(pending)) >= 0) {
+			placed |= infer_post(maze, cell % MAZE_SIZE,
+					     cell / MAZE_SIZE);
+			placed |= infer_post(maze, cell % MAZE_SIZE + 1,
+					     cell / MAZE_SIZE);
+			placed |= infer_post(maze, cell % MAZE_SIZE,
+					     cell / MAZE_SIZE + 1);
+			placed |= infer_post(maze, cell % MAZE_SIZE + 1,
+					     cell / MAZE_SIZE + 1);
+		}
+	}
+	return placed;
+}
+
+/**
+ * @brief Return whether a cell has been filled as part of a dead end.
+ */
+static bool cell_is_filled(struct maze_context *maze, CELL_INDEX cell)
+{
+	return maze->filled_cells[cell / MAZE_SIZE] & ROW_BIT(cell % MAZE_SIZE);
+}
+
+/**
+ * @brief Count the closed sides of a cell, for dead-end filling.
+ *
+ * A side is closed when its wall exists or when it leads to a filled cell,
+ * whether that side is open or not.
+ */
+static int closed_sides(struct maze_context *maze, CELL_INDEX cell)
+{
+	int i;
+	int closed = 0;
+	uint8_t bit;
+
+	for (i = 0; i < 4; i++) {
+		bit = direction_wall_bit(headings[i]);
+		if (wall_exists(maze, cell, bit))
+			closed++;
+		else if (cell_is_filled(maze, cell + headings[i]))
+			closed++;
+	}
+	return closed;
+}
+
+/**
+ * @brief Fill dead-end corridors.
+ *
+ * A cell with three closed sides cannot be part of any path between other
+ * cells, so it is filled, which may close a side of its only neighbor too.
+ * The start and goal cells are path ends and never filled. Filled cells
+ * which were not explored yet are marked as inferred.
+ *
+ * @param[in, out] pending Cells to evaluate, emptied on return. Open
+ * neighbors of filled cells are evaluated too.
+ */
+static void infer_dead_ends(struct maze_context *maze, ROW_BITBOARD *pending)
+{
+	int i;
+	int cell;
+	int next;
+
+	while ((cell = pop_cell(pending)) >= 0) {
+		if (cell == 0 || cell_is_filled(maze, cell) ||
+		    maze_cell_is_goal(maze, cell))
+			continue;
+		if (closed_sides(maze, cell) < 3)
+			continue;
+		maze->filled_cells[cell / MAZE_SIZE] |=
+		    ROW_BIT(cell % MAZE_SIZE);
+		for (i = 0; i < 4; i++) {
+			if (wall_exists(maze, cell,
+					direction_wall_bit(headings[i])))
+				continue;
+			next = cell + headings[i];
+			pending[next / MAZE_SIZE] |= ROW_BIT(next % MAZE_SIZE);
+		}
+		if (cell_is_explored(maze, cell))
+			continue;
+		maze->inferred_cells[cell / MAZE_SIZE] |=
+		    ROW_BIT(cell % MAZE_SIZE);
+		maze->inference_stats.dead_ends++;
+	}
+}
+
+/**
+ * @brief Flood the region around a cell until it reaches a reachable cell.
+ *
+ * Unknown walls are considered open. Visited cells can be reached from the
+ * start, as the robot has already been there, and so can the cells in
+ * `reachable`. The flood is expanded for all the cells of a row at once.
+ *
+ * @param[in] cell Cell to flood from.
+ * @param[in] reachable Cells known to be reachable from the start.
+ * @param[out] region Cells reached by the flood.
+ *
+ * @return Whether the region can be reached from the start.
+ */
+static bool flood_region(struct maze_context *maze, CELL_INDEX cell,
+			 const ROW_BITBOARD *reachable, ROW_BITBOARD *region)
+{
+	int y;
+	ROW_BITBOARD cells;
+	ROW_BITBOARD found = 1;
+	ROW_BITBOARD front[MAZE_SIZE] = {0};
+	ROW_BITBOARD next[MAZE_SIZE];
+
+	for (y = 0; y < MAZE_SIZE; y++)
+		region[y] = 0;
+	front[cell / MAZE_SIZE] = ROW_BIT(cell % MAZE_SIZE);
+	region[cell / MAZE_SIZE] = front[cell / MAZE_SIZE];
+	while (found) {
+		for (y = 0; y < MAZE_SIZE; y++) {
+			if (front[y] & reachable[y])
+				return true;
+			cells = front[y];
+			for (; cells; cells &= (ROW_BITBOARD)(cells - 1))
+				if (maze->maze_walls[y * MAZE_SIZE +
+						     __builtin_ctz(cells)] &
+				    VISITED_BIT)
+					return true;
+		}
+		found = 0;
+		for (y = 0; y < MAZE_SIZE; y++) {
+			cells = (ROW_BITBOARD)((front[y] & ~maze->east_walls[y])
+					       << 1);
+			cells |= (ROW_BITBOARD)(front[y] >> 1) &
+				 ~maze->east_walls[y];
+			if (y > 0)
+				cells |= front[y - 1] &
+					 ~maze->north_walls[y - 1];
+			if (y < MAZE_SIZE - 1)
+				cells |= front[y + 1] & ~maze->north_walls[y];
+			next[y] = cells & ~region[y];
+			found |= next[y];
+		}
+		for (y = 0; y < MAZE_SIZE; y++) {
+			front[y] = next[y];
+			region[y] |= next[y];
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief Mark the cells that cannot be reached from the start as inferred.
+ *
+ * Reachability considers unknown walls as open, so these cells are in
+ * regions closed by known walls and cannot be part of any path. A region can
+ * only be closed by a new wall, so only the regions around the changed cells
+ * are flooded, and only until they reach a cell known to be reachable.
+ *
+ * @param[in, out] seeds Cells to flood from, emptied on return.
+ */
+static void infer_closed_regions(struct maze_context *maze,
+				 ROW_BITBOARD *seeds)
+{
+	int y;
+	int cell;
+	ROW_BITBOARD region[MAZE_SIZE];
+	ROW_BITBOARD reachable[MAZE_SIZE] = {ROW_BIT(0)};
+
+	while ((cell = pop_cell(seeds)) >= 0) {
+		if (maze->maze_walls[cell] & VISITED_BIT)
+			continue;
+		if (reachable[cell / MAZE_SIZE] & ROW_BIT(cell % MAZE_SIZE))
+			continue;
+		if (flood_region(maze, cell, reachable, region)) {
+			for (y = 0; y < MAZE_SIZE; y++)
+				reachable[y] |= region[y];
+			continue;
+		}
+		for (y = 0; y < MAZE_SIZE; y++) {
+			seeds[y] &= ~region[y];
+			maze->inference_stats.closed += __builtin_popcount(
+			    region[y] & ~maze->inferred_cells[y]);
+			maze->inferred_cells[y] |= region[y];
+		}
+	}
+}
+
+/**
+ * @brief Deduce walls and cells from the maze constraints.
+ *
+ * To be run after `update_walls()`. Deduced walls are marked as known and
+ * cells whose walls are determined, or which cannot be part of any path, are
+ * marked as inferred, so that they are never targeted for exploration. They
+ * are not marked as visited, as their walls have not been read.
+ *
+ * The inference is incremental: the rules are only evaluated around the cells
+ * whose observed walls changed since the last call.
+ *
+ * @return Whether any new wall was placed in the maze.
+ */
+bool maze_infer_walls(struct maze_context *maze)
+{
+	int y;
+	bool placed;
+	ROW_BITBOARD dead_ends[MAZE_SIZE];
+	ROW_BITBOARD regions[MAZE_SIZE];
+
+	maze->inference_stats.observed += mark_determined_cells(maze);
+	placed = infer_start_walls(maze);
+	maze->inference_stats.start += mark_determined_cells(maze);
+	placed |= infer_post_walls(maze);
+	maze->inference_stats.posts += mark_determined_cells(maze);
+	for (y = 0; y < MAZE_SIZE; y++) {
+		dead_ends[y] = maze->changed_cells[y];
+		regions[y] = maze->changed_cells[y];
+		maze->changed_cells[y] = 0;
+	}
+	infer_dead_ends(maze, dead_ends);
+	infer_closed_regions(maze, regions);
+	return placed;
+}
+
+/**
+ * @brief Return the number of cells determined by each inference rule.
+ */
+struct inference_stats maze_get_inference_stats(struct maze_context *maze)
+{
+	return maze->inference_stats;
+}
+
+/**
+ * @brief Set the best unexplored cells as exploration targets.
+ *
+ * Candidates are unexplored cells through which the start-to-goal path could
+ * be shorter than the known one. They are ranked by a weighted sum of the
+ * travel distance from the current position to the cell and from the cell
+ * back to the start, and the optimistic length of the best start-to-goal path
+ * through it, weighted with `FRONTIER_LENGTH_WEIGHT`. This balances the cost
+ * of reaching a cell with how much it could shorten the known path, so a far
+ * cell only wins if it could improve the path enough to be worth the extra
+ * travel. Ties are ranked by the optimistic path length. All the best ranked
+ * candidates, up to `MAX_TARGETS`, are set as targets.
+ *
+ * Distances are not modified, so they must be set afterwards.
+ *
+ * @return Whether any target was set.
+ */
+bool maze_set_frontier_targets(struct maze_context *maze)
+{
+	int cell;
+	uint16_t score;
+	uint16_t length;
+	uint16_t best_score = UINT16_MAX;
+	uint16_t best_length = UINT16_MAX;
+	CELL_DISTANCE known_length;
+	ROW_BITBOARD east[MAZE_SIZE];
+	ROW_BITBOARD north[MAZE_SIZE];
+	CELL_DISTANCE *from_start = maze->frontier_distances[0];
+	CELL_DISTANCE *from_goal = maze->frontier_distances[1];
+	CELL_DISTANCE *from_robot = maze->frontier_distances[2];
+	struct cells_stack start = {.cells = {0}, .size = 1};
+	struct cells_stack robot = {.cells = {maze->current_position},
+				    .size = 1};
+
+	build_pessimistic_walls(maze, east, north);
+	known_length = flood_bitboard(east, north, &maze->goal_cells, NULL, 0);
+	flood_bitboard(maze->east_walls, maze->north_walls, &start, from_start,
+		       0);
+	flood_bitboard(maze->east_walls, maze->north_walls, &maze->goal_cells,
+		       from_goal, 0);
+	flood_bitboard(maze->east_walls, maze->north_walls, &robot, from_robot,
+		       0);
+
+	maze->target_cells.size = 0;
+	for (cell = 0; cell < MAZE_AREA; cell++) {
+		if (cell_is_explored(maze, cell))
+			continue;
+		if (from_robot[cell] == MAX_DISTANCE)
+			continue;
+		length = from_start[cell] + from_goal[cell];
+		if (length >= known_length)
+			continue;
+		score = from_robot[cell] + from_start[cell] +
+			FRONTIER_LENGTH_WEIGHT * length;
+		if (score > best_score ||
+		    (score == best_score && length > best_length))
+			continue;
+		if (score < best_score || length < best_length) {
+			best_score = score;
+			best_length = length;
+			maze->target_cells.size = 0;
+		}
+		if (maze->target_cells.size < MAX_TARGETS)
+			add_target(maze, cell);
+	}
+	return maze->target_cells.size > 0;
+}
+
+/**
+ * @brief Find an unexplored and potentially interesting cell.
+ *
+ * Follows the best path from the start to the goal, considering unknown
+ * walls do not exist, and returns the first cell that has not been visited
+ * nor inferred.
+ * Distances, targets and the search position are not modified.
+ *
+ * @return The unexplored cell, or zero if there is none on the path.
+ */
+CELL_INDEX maze_find_unexplored_interesting_cell(struct maze_context *maze)
+{
+	int i;
+	uint8_t bit;
+	CELL_INDEX cell = 0;
+	CELL_DISTANCE path[MAZE_AREA];
+	enum compass_direction direction = maze->initial_direction;
+	enum compass_direction candidate;
+	enum compass_direction next;
+	const enum step_direction steps[3] = {FRONT, LEFT, RIGHT};
+
+	flood_bitboard(maze->east_walls, maze->north_walls, &maze->goal_cells,
+		       path, 0);
+	while (path[cell] > 0 && path[cell] != MAX_DISTANCE) {
+		next = rotate_direction(direction, BACK);
+		for (i = 0; i < 3; i++) {
+			candidate = rotate_direction(direction, steps[i]);
+			bit = direction_wall_bit(candidate);
+			if (!wall_exists(maze, cell, bit) &&
+			    path[cell + candidate] < path[cell]) {
+				next = candidate;
+				break;
+			}
+		}
+		direction = next;
+		cell += direction;
+		if (!cell_is_explored(maze, cell))
+			return cell;
+	}
+	return 0;
+}
+
+/**
+ * @brief Set the costs to use for time-weighted distances.
+ *
+ * Costs are clamped to the range supported by the bucket queue.
+ *
+ * @param[in] value Costs of moving straight, turning and turning back.
+ */
+void maze_set_search_costs(struct maze_context *maze, struct search_costs value)
+{
+	maze->costs = value;
+	if (maze->costs.straight < 1)
+		maze->costs.straight = 1;
+	if (maze->costs.straight > MAX_SEARCH_COST)
+		maze->costs.straight = MAX_SEARCH_COST;
+	if (maze->costs.turn < 1)
+		maze->costs.turn = 1;
+	if (maze->costs.turn > MAX_SEARCH_COST)
+		maze->costs.turn = MAX_SEARCH_COST;
+	if (maze->costs.back < 1)
+		maze->costs.back = 1;
+	if (maze->costs.back > MAX_SEARCH_COST)
+		maze->costs.back = MAX_SEARCH_COST;
+}
+
+/**
+ * @brief Return the windrose index of a compass direction.
+ */
+static int heading_index(enum compass_direction direction)
+{
+	switch (direction) {
+	case EAST:
+		return 0;
+	case SOUTH:
+		return 1;
+	case WEST:
+		return 2;
+	default:
+		return 3;
+	}
+}
+
+/**
+ * @brief Return the cost of moving into the next cell.
+ *
+ * @param[in] heading Current heading index.
+ * @param[in] next Heading index of the movement.
+ */
+static uint16_t step_cost(struct maze_context *maze, int heading, int next)
+{
+	if (heading == next)
+		return maze->costs.straight;
+	if ((heading + 2) % 4 == next)
+		return maze->costs.back;
+	return maze->costs.turn;
+}
+
+/**
+ * @brief Check if a wall exists in a set of row bitboards.
+ *
+ * @param[in] east Row bitmasks of the east walls.
+ * @param[in] north Row bitmasks of the north walls.
+ * @param[in] cell Cell position.
+ * @param[in] heading Heading index of the wall side in the cell.
+ */
+static bool bitboard_wall_exists(const ROW_BITBOARD *east,
+				 const ROW_BITBOARD *north, CELL_INDEX cell,
+				 int heading)
+{
+	int x = cell % MAZE_SIZE;
+	int y = cell / MAZE_SIZE;
+
+	switch (heading) {
+	case 0:
+		return east[y] & ROW_BIT(x);
+	case 1:
+		return y == 0 || (north[y - 1] & ROW_BIT(x));
+	case 2:
+		return x == 0 || (east[y] & ROW_BIT(x - 1));
+	default:
+		return north[y] & ROW_BIT(x);
+	}
+}
+
+static void bucket_insert(struct maze_context *maze, int16_t state,
+			  WEIGHTED_DISTANCE distance)
+{
+	int bucket = distance % WEIGHTED_BUCKETS;
+
+	maze->bucket_prev[state] = -1;
+	maze->bucket_next[state] = maze->bucket_heads[bucket];
+	if (maze->bucket_heads[bucket] >= 0)
+		maze->bucket_prev[maze->bucket_heads[bucket]] = state;
+	maze->bucket_heads[bucket] = state;
+}
+
+static void bucket_remove(struct maze_context *maze, int16_t state,
+			  WEIGHTED_DISTANCE distance)
+{
+	int bucket = distance % WEIGHTED_BUCKETS;
+
+	if (maze->bucket_prev[state] >= 0)
+		maze->bucket_next[maze->bucket_prev[state]] =
+		    maze->bucket_next[state];
+	else
+		maze->bucket_heads[bucket] = maze->bucket_next[state];
+	if (maze->bucket_next[state] >= 0)
+		maze->bucket_prev[maze->bucket_next[state]] =
+		    maze->bucket_prev[state];
+}
+
+/**
+ * @brief Set time-weighted distances with respect to the target.
+ *
+ * Dijkstra search backwards from the target over (cell, heading) states,
+ * with a bucket queue. Settling the state of a cell and heading relaxes the
+ * states of the previous cell in that heading, for every possible heading
+ * in that previous cell, with the corresponding step cost.
+ *
+ * @param[in] east Row bitmasks of the east walls.
+ * @param[in] north Row bitmasks of the north walls.
+ */
+static void flood_weighted(struct maze_context *maze, const ROW_BITBOARD *east,
+			   const ROW_BITBOARD *north)
+{
+	int i;
+	int heading;
+	int next;
+	int16_t state;
+	CELL_INDEX cell;
+	CELL_INDEX previous;
+	WEIGHTED_DISTANCE current = 0;
+	WEIGHTED_DISTANCE *known;
+	WEIGHTED_DISTANCE distance;
+	int pending = 0;
+
+	for (i = 0; i < MAZE_AREA; i++)
+		for (heading = 0; heading < 4; heading++)
+			maze->weighted_distances[i][heading] =
+			    MAX_WEIGHTED_DISTANCE;
+	for (i = 0; i < WEIGHTED_BUCKETS; i++)
+		maze->bucket_heads[i] = -1;
+	for (i = 0; i < maze->target_cells.size; i++) {
+		cell = maze->target_cells.cells[i];
+		for (heading = 0; heading < 4; heading++) {
+			maze->weighted_distances[cell][heading] = 0;
+			bucket_insert(maze, cell * 4 + heading, 0);
+			pending++;
+		}
+	}
+
+	while (pending) {
+		while (maze->bucket_heads[current % WEIGHTED_BUCKETS] < 0)
+			current++;
+		state = maze->bucket_heads[current % WEIGHTED_BUCKETS];
+		bucket_remove(maze, state, current);
+		pending--;
+		cell = state / 4;
+		next = state % 4;
+		if (bitboard_wall_exists(east, north, cell, (next + 2) % 4))
+			continue;
+		previous = cell - headings[next];
+		for (heading = 0; heading < 4; heading++) {
+			known = &maze->weighted_distances[previous][heading];
+			distance = current + step_cost(maze, heading, next);
+			if (distance >= *known)
+				continue;
+			state = previous * 4 + heading;
+			if (*known == MAX_WEIGHTED_DISTANCE)
+				pending++;
+			else
+				bucket_remove(maze, state, *known);
+			*known = distance;
+			bucket_insert(maze, state, distance);
+		}
+	}
+}
+
+/**
+ * @brief Set time-weighted maze distances with respect to the target.
+ *
+ * Moving straight, turning and turning back are charged with the costs set
+ * with `set_search_costs()`.
+ */
+void maze_set_weighted_distances(struct maze_context *maze)
+{
+	flood_weighted(maze, maze->east_walls, maze->north_walls);
+}
+
+/**
+ * @brief Set pessimistic time-weighted distances with respect to the target.
+ *
+ * Walls that have not been observed yet are considered to exist.
+ */
+void maze_set_weighted_distances_pessimistic(struct maze_context *maze)
+{
+	ROW_BITBOARD east[MAZE_SIZE];
+	ROW_BITBOARD north[MAZE_SIZE];
+
+	build_pessimistic_walls(maze, east, north);
+	flood_weighted(maze, east, north);
+}
+
+/**
+ * @brief Return the time-weighted cost to reach the target through a step.
+ */
+static uint32_t weighted_step_distance(struct maze_context *maze,
+				       enum step_direction step)
+{
+	enum compass_direction direction = next_compass_direction(maze, step);
+	int next = heading_index(direction);
+
+	return step_cost(maze, heading_index(maze->current_direction), next) +
+	       maze->weighted_distances[maze->current_position + direction]
+				       [next];
+}
+
+/**
+ * @brief Return the best step according to the time-weighted distances.
+ *
+ * Ties are resolved preferring front, then left, then right, then back. Going
+ * back is also the fallback when no other step is possible.
+ *
+ * @param[in] walls Walls around, relative to the current direction.
+ */
+enum step_direction maze_best_weighted_neighbor_step(struct maze_context *maze,
+						     struct walls_around walls)
+{
+	enum step_direction best = BACK;
+	uint32_t best_distance = MAX_WEIGHTED_DISTANCE;
+	uint32_t distance;
+
+	if (!walls.front) {
+		distance = weighted_step_distance(maze, FRONT);
+		if (distance < best_distance) {
+			best = FRONT;
+			best_distance = distance;
+		}
+	}
+	if (!walls.left) {
+		distance = weighted_step_distance(maze, LEFT);
+		if (distance < best_distance) {
+			best = LEFT;
+			best_distance = distance;
+		}
+	}
+	if (!walls.right) {
+		distance = weighted_step_distance(maze, RIGHT);
+		if (distance < best_distance) {
+			best = RIGHT;
+			best_distance = distance;
+		}
+	}
+	if (!maze_current_side_wall(maze, BACK)) {
+		distance = weighted_step_distance(maze, BACK);
+		if (distance < best_distance)
+			best = BACK;
+	}
+	return best;
+}
+
+/*
+ * Functions operating on the default maze context.
+ */
+
+/**
+ * @brief Get the default maze context, initializing it on first use.
+ *
+ * The non-zero fields of `MAZE_CONTEXT_INIT` are set here, before any of the
+ * functions below can use them.
+ */
+static struct maze_context *default_context(void)
+{
+	if (!default_maze_initialized) {
+		default_maze.initial_direction = NORTH;
+		default_maze.costs = (struct search_costs){1, 1, 1};
+		default_maze_initialized = true;
+	}
+	return &default_maze;
+}
+
+CELL_DISTANCE read_cell_distance_value(CELL_INDEX cell)
+{
+	return maze_read_cell_distance_value(default_context(), cell);
+}
+
+uint8_t read_cell_walls_value(CELL_INDEX cell)
+{
+	return maze_read_cell_walls_value(default_context(), cell);
+}
+
+void add_goal(int x, int y)
+{
+	maze_add_goal(default_context(), x, y);
+}
+
+bool cell_is_goal(CELL_INDEX cell)
+{
+	return maze_cell_is_goal(default_context(), cell);
+}
+
+void set_goal_classic(void)
+{
+	maze_set_goal_classic(default_context());
+}
+
+void set_target_cell(CELL_INDEX cell)
+{
+	maze_set_target_cell(default_context(), cell);
+}
+
+void set_target_goal(void)
+{
+	maze_set_target_goal(default_context());
+}
+
+void set_search_initial_direction(enum compass_direction direction)
+{
+	maze_set_search_initial_direction(default_context(), direction);
+}
+
+void set_search_initial_state(void)
+{
+	maze_set_search_initial_state(default_context());
+}
+
+void set_search_state(CELL_INDEX position, enum compass_direction direction)
+{
+	maze_set_search_state(default_context(), position, direction);
+}
+
+bool current_side_wall(enum step_direction side)
+{
+	return maze_current_side_wall(default_context(), side);
+}
+
+uint8_t read_cell_known_walls_value(CELL_INDEX cell)
+{
+	return maze_read_cell_known_walls_value(default_context(), cell);
+}
+
+bool update_walls(struct walls_around walls)
+{
+	return maze_update_walls(default_context(), walls);
+}
+
+enum compass_direction search_direction(void)
+{
+	return maze_search_direction(default_context());
+}
+
+CELL_INDEX search_position(void)
+{
+	return maze_search_position(default_context());
+}
+
+CELL_DISTANCE search_distance(void)
+{
+	return maze_search_distance(default_context());
+}
+
+void initialize_maze_walls(void)
+{
+	maze_initialize_maze_walls(default_context());
+}
+
+enum step_direction best_neighbor_step(struct walls_around walls)
+{
+	return maze_best_neighbor_step(default_context(), walls);
+}
+
+void set_distances_queue(void)
+{
+	maze_set_distances_queue(default_context());
+}
+
+void set_distances_bitboard(void)
+{
+	maze_set_distances_bitboard(default_context());
+}
+
+void set_distances_pessimistic(void)
+{
+	maze_set_distances_pessimistic(default_context());
+}
+
+bool optimal_path_is_known(void)
+{
+	return maze_optimal_path_is_known(default_context());
+}
+
+void set_distances(void)
+{
+	maze_set_distances(default_context());
+}
+
+void update_distances(void)
+{
+	maze_update_distances(default_context());
+}
+
+void move_search_position(enum step_direction step)
+{
+	maze_move_search_position(default_context(), step);
+}
+
+bool current_cell_is_visited(void)
+{
+	return maze_current_cell_is_visited(default_context());
+}
+
+struct walls_around current_walls_around(void)
+{
+	return maze_current_walls_around(default_context());
+}
+
+struct walls_around current_walls_around_pessimistic(void)
+{
+	return maze_current_walls_around_pessimistic(default_context());
+}
+
+void take_walls_snapshot(struct walls_snapshot *snapshot)
+{
+	maze_take_walls_snapshot(default_context(), snapshot);
+}
+
+void restore_walls_snapshot(const struct walls_snapshot *snapshot)
+{
+	maze_restore_walls_snapshot(default_context(), snapshot);
+}
+
+bool infer_walls(void)
+{
+	return maze_infer_walls(default_context());
+}
+
+struct inference_stats get_inference_stats(void)
+{
+	return maze_get_inference_stats(default_context());
+}
+
+bool set_frontier_targets(void)
+{
+	return maze_set_frontier_targets(default_context());
+}
+
+CELL_INDEX find_unexplored_interesting_cell(void)
+{
+	return maze_find_unexplored_interesting_cell(default_context());
+}
+
+void set_search_costs(struct search_costs value)
+{
+	maze_set_search_costs(default_context(), value);
+}
+
+void set_weighted_distances(void)
+{
+	maze_set_weighted_distances(default_context());
+}
+
+void set_weighted_distances_pessimistic(void)
+{
+	maze_set_weighted_distances_pessimistic(default_context());
+}
+
+enum step_direction best_weighted_neighbor_step(struct walls_around walls)
+{
+	return maze_best_weighted_neighbor_step(default_context(), walls);
 }
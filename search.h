@@ -6,10 +6,59 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+/**
+ * Number of cells on each side of the maze.
+ *
+ * Define `MAZE_SIZE` at compile time to select it. The cell index, distance
+ * and row bitboard types are chosen to fit it, so the classic 16x16 maze
+ * keeps using single bytes for cells and distances.
+ */
+#ifndef MAZE_SIZE
 #define MAZE_SIZE 16
-#define MAZE_AREA (16 * 16)
+#endif
+#define MAZE_AREA (MAZE_SIZE * MAZE_SIZE)
 #define MAX_TARGETS 10
 #define MAX_DISTANCE (MAZE_AREA - 1)
+#define MAX_SEARCH_COST 255
+#if MAZE_SIZE <= 16
+#define CELL_INDEX uint8_t
+#define CELL_DISTANCE uint8_t
+#define ROW_BITBOARD uint16_t
+#define WEIGHTED_DISTANCE uint16_t
+#define MAX_WEIGHTED_DISTANCE (UINT16_MAX - MAX_SEARCH_COST)
+#elif MAZE_SIZE <= 32
+#define CELL_INDEX uint16_t
+#define CELL_DISTANCE uint16_t
+#define ROW_BITBOARD uint32_t
+#define WEIGHTED_DISTANCE uint32_t
+#define MAX_WEIGHTED_DISTANCE (UINT32_MAX - MAX_SEARCH_COST)
+#else
+#error "Unsupported MAZE_SIZE, must be up to 32"
+#endif
+#define WEIGHTED_BUCKETS (MAX_SEARCH_COST + 1)
+
+/**
+ * Flood-fill engines available for `set_distances()`.
+ *
+ * Define `SEARCH_FLOOD_ENGINE` at compile time to select one of them.
+ */
+#define SEARCH_FLOOD_QUEUE 0
+#define SEARCH_FLOOD_BITBOARD 1
+#ifndef SEARCH_FLOOD_ENGINE
+#define SEARCH_FLOOD_ENGINE SEARCH_FLOOD_QUEUE
+#endif
+
+/**
+ * Weight of the optimistic start-to-goal path length through a cell when
+ * ranking exploration frontier cells, relative to the travel distance to the
+ * cell and back to the start.
+ *
+ * Higher weights favor cells that could shorten the path the most, even if
+ * they are far from the current position.
+ */
+#ifndef FRONTIER_LENGTH_WEIGHT
+#define FRONTIER_LENGTH_WEIGHT 2
+#endif
 
 #define VISITED_BIT 1
 #define EAST_BIT 2
@@ -32,26 +81,224 @@ struct walls_around {
 
 enum step_direction { NONE = -1, LEFT = 0, FRONT = 1, RIGHT = 2, BACK = 3 };
 
-uint8_t read_cell_distance_value(uint8_t cell);
-uint8_t read_cell_walls_value(uint8_t cell);
+/**
+ * Costs of moving into the next cell, for time-weighted distances.
+ *
+ * - Moving straight (keeping the current heading)
+ * - Turning left or right
+ * - Turning back
+ */
+struct search_costs {
+	uint16_t straight;
+	uint16_t turn;
+	uint16_t back;
+};
+
+/**
+ * Cells determined by each wall inference rule, without visiting them.
+ *
+ * - All walls observed from the neighbor cells
+ * - Every post has at least one wall
+ * - The start cell layout is known
+ * - Dead-end corridors are filled
+ * - Regions closed from the start are unreachable
+ */
+struct inference_stats {
+	uint16_t observed;
+	uint16_t posts;
+	uint16_t start;
+	uint16_t dead_ends;
+	uint16_t closed;
+};
+
+/**
+ * Compact copy of the maze knowledge, to be persisted.
+ *
+ * - Row bitboards of the walls, with the same layout as the maze context
+ * - Row bitboards of the observed walls, with the same layout
+ * - Row bitboards of the visited cells
+ */
+struct walls_snapshot {
+	ROW_BITBOARD east_walls[MAZE_SIZE];
+	ROW_BITBOARD north_walls[MAZE_SIZE];
+	ROW_BITBOARD known_east_walls[MAZE_SIZE];
+	ROW_BITBOARD known_north_walls[MAZE_SIZE];
+	ROW_BITBOARD visited_cells[MAZE_SIZE];
+};
+
+struct cells_stack {
+	int cells[MAX_TARGETS];
+	uint8_t size;
+};
+
+struct data_queue {
+	CELL_INDEX buffer[MAZE_AREA];
+	int head;
+	int tail;
+};
+
+/**
+ * Search state of a maze, so that several mazes or targets can be handled
+ * independently. The functions without a context use a default instance.
+ * New contexts must be initialized with `MAZE_CONTEXT_INIT`.
+ *
+ * - Distances of each cell to the target
+ * - Walls of each cell, including the visited bit
+ * - Row bitboards of the walls, kept in sync with `maze_walls`. Bit `x` of
+ *   `east_walls[y]` is set when cell `(x, y)` has its east wall, and bit `x`
+ *   of `north_walls[y]` is set when it has its north wall. West and south
+ *   walls are represented by the east and north walls of the neighbors.
+ * - Row bitboards of the observed walls, with the same layout. A bit is set
+ *   when the wall side has been observed, whether the wall exists or not.
+ * - Initial direction of the robot at the start cell
+ * - Current position and direction of the robot
+ * - Queue for the breadth-first flood fill
+ * - Goal and target cells
+ * - Cells next to the walls placed since the last distances update. If more
+ *   walls are placed than what can be stored, the next distances update will
+ *   be a full flood fill.
+ * - Cells currently in the queue, for the incremental distances update
+ * - Dead-end cells filled by the wall inference, as row bitboards
+ * - Cells which need no exploration according to the wall inference, as row
+ *   bitboards. They are kept apart from the visited bit, which is only set on
+ *   cells whose walls have been read.
+ * - Cells whose observed walls changed since the last wall inference, as row
+ *   bitboards. Only the inference rules around these cells are evaluated.
+ * - Cells determined by each inference rule without visiting them
+ * - Optimistic distances used to select the exploration frontier: from the
+ *   start, from the goal and from the current position
+ * - Time-weighted distances, for each cell and heading, and their costs.
+ *   Headings are indexed in windrose order (east, south, west and north).
+ *   The distance is the cost to reach the target from the cell when the
+ *   robot is moving in that heading.
+ * - Circular buckets (Dial's algorithm) of the time-weighted states waiting
+ *   to be settled, as doubly linked lists
+ *
+ * Each context takes about 8.4 KB of RAM with a 16x16 maze (45 KB with a
+ * 32x32 maze). Most of it is used by the time-weighted search only: 2 KB for
+ * the weighted distances and 4.5 KB for the buckets, plus 0.75 KB for the
+ * frontier distances. They are always present, whatever the flood-fill
+ * engine and whether the time-weighted search is enabled or not.
+ */
+struct maze_context {
+	CELL_DISTANCE distances[MAZE_AREA];
+	uint8_t maze_walls[MAZE_AREA];
+	ROW_BITBOARD east_walls[MAZE_SIZE];
+	ROW_BITBOARD north_walls[MAZE_SIZE];
+	ROW_BITBOARD known_east_walls[MAZE_SIZE];
+	ROW_BITBOARD known_north_walls[MAZE_SIZE];
+	enum compass_direction initial_direction;
+	CELL_INDEX current_position;
+	enum compass_direction current_direction;
+	struct data_queue queue;
+	struct cells_stack goal_cells;
+	struct cells_stack target_cells;
+	struct cells_stack new_wall_cells;
+	bool new_wall_cells_overflow;
+	ROW_BITBOARD queued_cells[MAZE_SIZE];
+	ROW_BITBOARD filled_cells[MAZE_SIZE];
+	ROW_BITBOARD inferred_cells[MAZE_SIZE];
+	ROW_BITBOARD changed_cells[MAZE_SIZE];
+	struct inference_stats inference_stats;
+	CELL_DISTANCE frontier_distances[3][MAZE_AREA];
+	WEIGHTED_DISTANCE weighted_distances[MAZE_AREA][4];
+	struct search_costs costs;
+	int16_t bucket_heads[WEIGHTED_BUCKETS];
+	int16_t bucket_next[MAZE_AREA * 4];
+	int16_t bucket_prev[MAZE_AREA * 4];
+};
+
+#define MAZE_CONTEXT_INIT {.initial_direction = NORTH, .costs = {1, 1, 1}}
+
+CELL_DISTANCE maze_read_cell_distance_value(struct maze_context *maze,
+					    CELL_INDEX cell);
+uint8_t maze_read_cell_walls_value(struct maze_context *maze, CELL_INDEX cell);
+void maze_add_goal(struct maze_context *maze, int x, int y);
+bool maze_cell_is_goal(struct maze_context *maze, CELL_INDEX cell);
+void maze_set_goal_classic(struct maze_context *maze);
+void maze_set_target_cell(struct maze_context *maze, CELL_INDEX cell);
+void maze_set_target_goal(struct maze_context *maze);
+void maze_set_search_initial_direction(struct maze_context *maze,
+				       enum compass_direction direction);
+void maze_set_search_initial_state(struct maze_context *maze);
+void maze_set_search_state(struct maze_context *maze, CELL_INDEX position,
+			   enum compass_direction direction);
+bool maze_current_side_wall(struct maze_context *maze,
+			    enum step_direction side);
+uint8_t maze_read_cell_known_walls_value(struct maze_context *maze,
+					 CELL_INDEX cell);
+bool maze_update_walls(struct maze_context *maze, struct walls_around walls);
+enum compass_direction maze_search_direction(struct maze_context *maze);
+CELL_INDEX maze_search_position(struct maze_context *maze);
+CELL_DISTANCE maze_search_distance(struct maze_context *maze);
+void maze_initialize_maze_walls(struct maze_context *maze);
+enum step_direction maze_best_neighbor_step(struct maze_context *maze,
+					    struct walls_around walls);
+void maze_set_distances_queue(struct maze_context *maze);
+void maze_set_distances_bitboard(struct maze_context *maze);
+void maze_set_distances_pessimistic(struct maze_context *maze);
+bool maze_optimal_path_is_known(struct maze_context *maze);
+void maze_set_distances(struct maze_context *maze);
+void maze_update_distances(struct maze_context *maze);
+void maze_move_search_position(struct maze_context *maze,
+			       enum step_direction step);
+bool maze_current_cell_is_visited(struct maze_context *maze);
+struct walls_around maze_current_walls_around(struct maze_context *maze);
+struct walls_around
+maze_current_walls_around_pessimistic(struct maze_context *maze);
+void maze_take_walls_snapshot(struct maze_context *maze,
+			      struct walls_snapshot *snapshot);
+void maze_restore_walls_snapshot(struct maze_context *maze,
+				 const struct walls_snapshot *snapshot);
+bool maze_infer_walls(struct maze_context *maze);
+struct inference_stats maze_get_inference_stats(struct maze_context *maze);
+bool maze_set_frontier_targets(struct maze_context *maze);
+CELL_INDEX maze_find_unexplored_interesting_cell(struct maze_context *maze);
+void maze_set_search_costs(struct maze_context *maze,
+			   struct search_costs value);
+void maze_set_weighted_distances(struct maze_context *maze);
+void maze_set_weighted_distances_pessimistic(struct maze_context *maze);
+enum step_direction maze_best_weighted_neighbor_step(struct maze_context *maze,
+						     struct walls_around walls);
+
+CELL_DISTANCE read_cell_distance_value(CELL_INDEX cell);
+uint8_t read_cell_walls_value(CELL_INDEX cell);
+uint8_t read_cell_known_walls_value(CELL_INDEX cell);
 void add_goal(int x, int y);
+bool cell_is_goal(CELL_INDEX cell);
 void set_goal_classic(void);
 void set_search_initial_direction(enum compass_direction direction);
 void set_search_initial_state(void);
+void set_search_state(CELL_INDEX position, enum compass_direction direction);
 enum compass_direction search_direction(void);
 bool current_side_wall(enum step_direction side);
 void move_search_position(enum step_direction step);
 enum step_direction best_neighbor_step(struct walls_around walls);
-uint8_t search_position(void);
-uint8_t search_distance(void);
+CELL_INDEX search_position(void);
+CELL_DISTANCE search_distance(void);
 enum step_direction search_step(bool left, bool front, bool right);
 void initialize_maze_walls(void);
 void set_distances(void);
-void set_target_cell(uint8_t cell);
+void set_distances_queue(void);
+void set_distances_bitboard(void);
+void set_distances_pessimistic(void);
+bool optimal_path_is_known(void);
+void set_target_cell(CELL_INDEX cell);
 void set_target_goal(void);
-void update_walls(struct walls_around walls);
+bool update_walls(struct walls_around walls);
+void take_walls_snapshot(struct walls_snapshot *snapshot);
+void restore_walls_snapshot(const struct walls_snapshot *snapshot);
+bool infer_walls(void);
+struct inference_stats get_inference_stats(void);
+void update_distances(void);
 bool current_cell_is_visited(void);
 struct walls_around current_walls_around(void);
-uint8_t find_unexplored_interesting_cell(void);
+struct walls_around current_walls_around_pessimistic(void);
+CELL_INDEX find_unexplored_interesting_cell(void);
+bool set_frontier_targets(void);
+void set_search_costs(struct search_costs value);
+void set_weighted_distances(void);
+void set_weighted_distances_pessimistic(void);
+enum step_direction best_weighted_neighbor_step(struct walls_around walls);
 
 #endif /* __SEARCH_H */
@@ -1,101 +1,599 @@
 #include "solve.h"
 
 #define RUN_SEQUENCE_LEN (MAZE_AREA + 3)
-#define EEPROM_NUM_BYTES_ERASED_CHECKED ((uint8_t)4)
-#define EEPROM_BYTE_ERASED_VALUE 255
+#define MAZE_RECORD_VERSION 1
+#define MAZE_RECORD_SLOTS 2
+#define SEARCH_COST_STRAIGHT 16
+#define RUN_COST_UNITS_PER_SECOND 1000
+#define FAST_TRAVERSAL_MIN_CELLS 3
+#define RUN_PATH_LANGUAGE PATH_DIAGONALS_FAST
 static char run_sequence[RUN_SEQUENCE_LEN];
+static bool time_weighted_search_enabled;
+static float fast_traversal_force;
+static float run_back_diagonals_force;
+static bool run_end_known;
+static CELL_INDEX run_end_position;
+static enum compass_direction run_end_direction;
+
+/**
+ * Maze record, as persisted on the EEPROM.
+ *
+ * Records are written alternately to the maze and the journal pages, so that
+ * the latest complete record survives an interrupted write.
+ *
+ * - Record format version
+ * - Maze size
+ * - Sequence number, increased with each record written
+ * - Walls, observed walls and visited cells
+ * - CRC-32 of all the previous fields
+ */
+struct maze_record {
+	uint8_t version;
+	uint8_t size;
+	uint16_t sequence;
+	struct walls_snapshot walls;
+	uint32_t crc;
+};
+
+static const uint32_t maze_record_addresses[MAZE_RECORD_SLOTS] = {
+    FLASH_EEPROM_ADDRESS_MAZE, FLASH_EEPROM_ADDRESS_JOURNAL};
+
+/**
+ * @brief Enable or disable time-weighted search.
+ *
+ * When enabled, paths are chosen minimizing the estimated travel time, taking
+ * into account turns, instead of the number of cells.
+ */
+void time_weighted_search(bool value)
+{
+	time_weighted_search_enabled = value;
+}
+
+/**
+ * @brief Enable or disable fast traversal of explored cells during search.
+ *
+ * When enabled, runs of already visited cells on the way to the target are
+ * traversed as a single smooth path, with diagonals and at run speed, instead
+ * of cell by cell.
+ *
+ * @param[in] force Maximum force to apply on the tires while traversing, or
+ * zero to disable fast traversal.
+ */
+void fast_traversal(float force)
+{
+	fast_traversal_force = force;
+}
+
+/**
+ * @brief Set the maximum force to run back with diagonals.
+ *
+ * Diagonals make the return leg faster, but they are less tolerant to errors.
+ * They are used when running back with a force up to the given value.
+ *
+ * @param[in] force Maximum force to run back with diagonals, or zero to
+ * always run back without diagonals.
+ */
+void run_back_diagonals(float force)
+{
+	run_back_diagonals_force = force;
+}
+
+/**
+ * @brief Configure the search costs from the current kinematic configuration.
+ *
+ * Costs are relative to the time to move straight into the next cell, which
+ * is set to `SEARCH_COST_STRAIGHT`.
+ *
+ * @param[in] force Maximum force to apply on the tires.
+ */
+static void configure_search_costs(float force)
+{
+	float straight_time = CELL_DIMENSION / get_max_linear_speed();
+	struct search_costs costs;
+
+	costs.straight = SEARCH_COST_STRAIGHT;
+	costs.turn = (uint16_t)(SEARCH_COST_STRAIGHT *
+				    get_move_turn_time(MOVE_LEFT, force) /
+				    straight_time +
+				0.5);
+	costs.back = (uint16_t)(SEARCH_COST_STRAIGHT *
+				    required_time_to_move_back(force) /
+				    straight_time +
+				0.5);
+	set_search_costs(costs);
+}
+
+/**
+ * @brief Set the distances to use for the search with respect to the target.
+ */
+static void set_search_distances(void)
+{
+	set_distances();
+	if (time_weighted_search_enabled)
+		set_weighted_distances();
+}
+
+/**
+ * @brief Return the best step to take, according to the search distances.
+ *
+ * @param[in] walls Walls around, relative to the current direction.
+ */
+static enum step_direction best_search_step(struct walls_around walls)
+{
+	if (time_weighted_search_enabled)
+		return best_weighted_neighbor_step(walls);
+	return best_neighbor_step(walls);
+}
+
+/**
+ * @brief Build the route through explored cells from the current position.
+ *
+ * The route follows the search steps through visited cells, ending when
+ * entering the first cell that has not been visited yet or the target. It is
+ * cut after its last front step, so that the smooth path does not end with a
+ * turn. The search position is left untouched.
+ *
+ * @param[out] sequence Raw movement sequence of the route.
+ *
+ * @return The number of steps in the route, or zero if it cannot be traversed
+ * as a smooth path.
+ */
+static int explored_route(char *sequence)
+{
+	int i = 0;
+	int length = 0;
+	enum step_direction step;
+	CELL_INDEX position = search_position();
+	enum compass_direction direction = search_direction();
+
+	while (search_distance() > 0 && i < RUN_SEQUENCE_LEN - 1) {
+		step = best_search_step(current_walls_around());
+		if (step == FRONT)
+			sequence[i++] = 'F';
+		else if (step == LEFT)
+			sequence[i++] = 'L';
+		else if (step == RIGHT)
+			sequence[i++] = 'R';
+		else
+			break;
+		if (step == FRONT)
+			length = i;
+		move_search_position(step);
+		if (!current_cell_is_visited())
+			break;
+	}
+	set_search_state(position, direction);
+	sequence[length] = '\0';
+	if (sequence[0] != 'F' || length < FAST_TRAVERSAL_MIN_CELLS)
+		return 0;
+	return length;
+}
+
+/**
+ * @brief Move the search position through a raw movement sequence.
+ *
+ * @param[in] sequence Raw movement sequence, with front, left and right steps.
+ * @param[in] length Number of steps to move through.
+ */
+static void move_search_steps(char *sequence, int length)
+{
+	int i;
+
+	for (i = 0; i < length; i++) {
+		if (sequence[i] == 'F')
+			move_search_position(FRONT);
+		else if (sequence[i] == 'L')
+			move_search_position(LEFT);
+		else
+			move_search_position(RIGHT);
+	}
+}
+
+/**
+ * @brief Traverse the explored cells on the way to the target, if any.
+ *
+ * The robot ends entering the next cell at the search speed, so that the
+ * search can continue cell by cell from there. The search position is only
+ * advanced if the whole route was traversed.
+ *
+ * @param[in] force Maximum force to apply on the tires while searching.
+ *
+ * @return Whether a route through explored cells was traversed.
+ */
+static bool traverse_explored_route(float force)
+{
+	int length;
+	bool traversed;
+	char sequence[RUN_SEQUENCE_LEN];
+	float search_speed = get_max_linear_speed();
+
+	length = explored_route(sequence);
+	if (!length)
+		return false;
+	kinematic_configuration(fast_traversal_force, true);
+	traversed = move_through_explored(sequence, fast_traversal_force,
+					  search_speed);
+	kinematic_configuration(force, false);
+	if (!traversed)
+		return false;
+	move_search_steps(sequence, length);
+	return true;
+}
+
+/**
+ * @brief Calculate the CRC-32 (IEEE 802.3) of a block of data.
+ */
+static uint32_t crc32(const uint8_t *data, int size)
+{
+	int i;
+	uint32_t crc = 0xFFFFFFFF;
+
+	while (size--) {
+		crc ^= *data++;
+		for (i = 0; i < 8; i++)
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+	}
+	return ~crc;
+}
+
+static uint32_t maze_record_crc(struct maze_record *record)
+{
+	return crc32((uint8_t *)record, sizeof(*record) - sizeof(record->crc));
+}
+
+/**
+ * @brief Read the latest valid maze record from the EEPROM.
+ *
+ * Records with a different version or maze size, or with a wrong CRC, are
+ * ignored.
+ *
+ * @param[out] record Latest valid record.
+ *
+ * @return The slot of the record, or -1 if there is no valid record.
+ */
+static int read_maze_record(struct maze_record *record)
+{
+	int slot;
+	int latest = -1;
+	struct maze_record candidate;
+
+	for (slot = 0; slot < MAZE_RECORD_SLOTS; slot++) {
+		eeprom_read_data(maze_record_addresses[slot], sizeof(candidate),
+				 (uint8_t *)&candidate);
+		if (candidate.version != MAZE_RECORD_VERSION ||
+		    candidate.size != MAZE_SIZE ||
+		    candidate.crc != maze_record_crc(&candidate))
+			continue;
+		if (latest >= 0 &&
+		    (int16_t)(candidate.sequence - record->sequence) <= 0)
+			continue;
+		*record = candidate;
+		latest = slot;
+	}
+	return latest;
+}
+
+/**
+ * @brief Write the current maze to the EEPROM.
+ *
+ * The slot which does not hold the latest valid record is overwritten. This
+ * must only be called with the robot stopped, as writing to the flash may
+ * stall the control loop.
+ */
+static void write_maze_record(void)
+{
+	int slot;
+	uint32_t save_status;
+	struct maze_record record;
+
+	slot = read_maze_record(&record);
+	record.sequence = slot < 0 ? 0 : record.sequence + 1;
+	record.version = MAZE_RECORD_VERSION;
+	record.size = MAZE_SIZE;
+	take_walls_snapshot(&record.walls);
+	record.crc = maze_record_crc(&record);
+	save_status = eeprom_flash_page(
+	    maze_record_addresses[(slot + 1) % MAZE_RECORD_SLOTS],
+	    (uint8_t *)&record, sizeof(record));
+	if (save_status != RESULT_OK)
+		LOG_ERROR("EEPROM save error %" PRIu32, save_status);
+}
 
 /**
  * @brief Move from the current position to the defined target.
  *
+ * When exploring, the frontier targets are selected again whenever new walls
+ * are found, and it stops as soon as an optimal path from the start to the
+ * goal is known.
+ *
+ * Moves are queued one ahead. Through visited cells, the next step is planned
+ * and queued while the robot is still moving into the current cell. In cells
+ * not visited yet, the robot must enter the cell before its walls are read.
+ *
  * @param[in] force Maximum force to apply on the tires.
+ * @param[in] exploring Whether the targets are the exploration frontier.
  */
-static void go_to_target(float force)
+static void go_to_target(float force, bool exploring)
 {
+	bool placed;
 	enum step_direction step;
 	struct walls_around walls;
 
-	set_distances();
+	set_search_distances();
 	do {
 		if (!current_cell_is_visited()) {
+			wait_next_cell();
 			walls = read_walls();
-			update_walls(walls);
-			set_distances();
+			placed = update_walls(walls);
+			placed |= infer_walls();
+			if (exploring && optimal_path_is_known())
+				return;
+			if (placed && exploring) {
+				if (!set_frontier_targets())
+					return;
+				set_search_distances();
+			} else if (placed) {
+				update_distances();
+				if (time_weighted_search_enabled)
+					set_weighted_distances();
+			}
 		} else {
+			if (fast_traversal_force &&
+			    traverse_explored_route(force))
+				continue;
+			if (collision_detected())
+				return;
 			walls = current_walls_around();
 		}
 #ifdef MMSIM_SIMULATION
 		send_state();
 #endif
-		step = best_neighbor_step(walls);
+		step = best_search_step(walls);
 		move_search_position(step);
 		move(step, force);
 		if (collision_detected())
 			return;
 	} while (search_distance() > 0);
 
+	wait_next_cell();
 	walls = read_walls();
 	update_walls(walls);
+	infer_walls();
 }
 
 /**
- * @brief Execute the maze exploration.
+ * @brief Explore the maze from the current targets until returning to start.
  *
- * @param[in] force Maximum force to apply on the tires.
+ * After reaching each target, it will try to explore remaining parts until
+ * finding an optimal path. Exploration stops as soon as the optimistic and
+ * pessimistic start-to-goal distances are equal, returning to the start.
+ *
+ * The maze is written to the EEPROM at the end, or when a collision stops
+ * the exploration. These are the only points where the robot is stopped
+ * anyway, so the search itself is never stopped to write the flash.
  *
- * After reaching the goal, it will try to explore remaining parts until
- * finding an optimal path.
+ * @param[in] force Maximum force to apply on the tires.
+ * @param[in] exploring Whether the current targets are the frontier.
  */
-void explore(float force)
+static void explore_targets(float force, bool exploring)
 {
-	uint8_t cell;
-
-	initialize_maze_walls();
-	set_search_initial_state();
+	struct inference_stats stats;
 
 	while (true) {
-		go_to_target(force);
-		if (collision_detected())
+		go_to_target(force, exploring);
+		if (collision_detected()) {
+			write_maze_record();
 			return;
+		}
 		if (search_position() == 0)
 			break;
-		cell = find_unexplored_interesting_cell();
-		set_target_cell(cell);
+		exploring = !optimal_path_is_known() && set_frontier_targets();
+		if (!exploring)
+			set_target_cell(0);
 	}
 	stop_middle();
 	turn_to_start_position(force);
+	write_maze_record();
+	stats = get_inference_stats();
+	LOG_INFO("Inferred cells: %d observed, %d start, %d posts, "
+		 "%d dead ends, %d closed",
+		 stats.observed, stats.start, stats.posts, stats.dead_ends,
+		 stats.closed);
 }
 
 /**
- * @brief Define the movement sequence to be executed on speed runs.
+ * @brief Execute the maze exploration.
+ *
+ * The maze walls are initialized and the robot starts moving to the target.
+ * See `explore_targets()`.
+ *
+ * @param[in] force Maximum force to apply on the tires.
  */
-void set_run_sequence(void)
+void explore(float force)
 {
-	int i = 0;
-	enum step_direction step;
+	initialize_maze_walls();
+	infer_walls();
+	set_search_initial_state();
+	configure_search_costs(force);
+	explore_targets(force, false);
+}
+
+/**
+ * @brief Resume the maze exploration from the maze saved on EEPROM.
+ *
+ * Meant to be used after a collision during the exploration, or to extend a
+ * finished one, with the robot back at the start. The known walls are kept
+ * and the robot goes straight to the exploration frontier, traversing the
+ * explored cells as smooth paths. If fast traversal is disabled, it is
+ * enabled with the search force meanwhile. See `explore_targets()`.
+ *
+ * If there is no valid maze saved, a new exploration is started instead.
+ *
+ * @param[in] force Maximum force to apply on the tires.
+ */
+void resume_exploration(float force)
+{
+	struct maze_record record;
+	float traversal_force = fast_traversal_force;
 
+	if (read_maze_record(&record) < 0) {
+		explore(force);
+		return;
+	}
+	restore_walls_snapshot(&record.walls);
+	infer_walls();
 	set_search_initial_state();
-	set_target_goal();
-	set_distances();
+	configure_search_costs(force);
+	if (optimal_path_is_known() || !set_frontier_targets()) {
+		LOG_INFO("Nothing left to explore");
+		return;
+	}
+	if (!fast_traversal_force)
+		fast_traversal_force = force;
+	explore_targets(force, true);
+	fast_traversal_force = traversal_force;
+}
+
+/**
+ * @brief Configure the speed run movement costs, in milliseconds.
+ *
+ * @param[in] force Maximum force to apply on the tires.
+ * @param[out] costs Cost of each movement, indexed by `enum movement`.
+ */
+static void configure_run_costs(float force, uint16_t *costs)
+{
+	float cost;
+	enum movement move;
+
+	for (move = 0; move < MOVE_NONE; move++) {
+		if (move < MOVE_FRONT || move == MOVE_BACK) {
+			costs[move] = UINT16_MAX;
+			continue;
+		}
+		cost = get_move_time(move, force) * RUN_COST_UNITS_PER_SECOND;
+		if (cost < 1)
+			cost = 1;
+		if (cost > UINT16_MAX)
+			cost = UINT16_MAX;
+		costs[move] = (uint16_t)(cost + 0.5);
+	}
+}
+
+/**
+ * @brief Write the search steps to the target, from the current position.
+ *
+ * Ties between steps are broken with the fixed search step preference.
+ *
+ * @param[out] sequence Array to write the raw movement sequence to.
+ * @param[in] pessimistic Whether to consider unknown walls as existing.
+ *
+ * @return The number of steps written.
+ */
+static int write_search_steps(char *sequence, bool pessimistic)
+{
+	int i = 0;
+	enum step_direction step;
+	struct walls_around walls;
 
-	run_sequence[i++] = 'B';
 	while (search_distance() > 0) {
-		step = best_neighbor_step(current_walls_around());
+		if (pessimistic)
+			walls = current_walls_around_pessimistic();
+		else
+			walls = current_walls_around();
+		step = best_search_step(walls);
 		switch (step) {
 		case FRONT:
-			run_sequence[i++] = 'F';
+			sequence[i++] = 'F';
 			break;
 		case LEFT:
-			run_sequence[i++] = 'L';
+			sequence[i++] = 'L';
 			break;
 		case RIGHT:
-			run_sequence[i++] = 'R';
+			sequence[i++] = 'R';
 			break;
 		default:
 			break;
 		}
 		move_search_position(step);
 	}
+	return i;
+}
+
+/**
+ * @brief Write the fastest shortest steps to the target, from the start.
+ *
+ * Movement costs are estimated with the run kinematic configuration and the
+ * current force, restoring the current configuration afterwards. The search
+ * position is left at the target.
+ *
+ * @param[out] sequence Array to write the raw movement sequence to.
+ * @param[in] size Size of the array.
+ * @param[in] pessimistic Whether to consider unknown walls as existing.
+ *
+ * @return The number of steps written, or zero if no path was found.
+ */
+static int write_shortest_steps(char *sequence, int size, bool pessimistic)
+{
+	int length;
+	uint16_t costs[MOVE_NONE];
+	float force = get_max_force();
+	float max_linear_jerk = get_linear_jerk();
+	float max_linear_speed = get_max_linear_speed();
+
+	kinematic_configuration(force, true);
+	configure_run_costs(force, costs);
+	set_linear_jerk(max_linear_jerk);
+	set_max_linear_speed(max_linear_speed);
+	if (!plan_shortest_sequence(sequence, size, RUN_PATH_LANGUAGE, costs,
+				    pessimistic))
+		return 0;
+	length = strlen(sequence);
+	move_search_steps(sequence, length);
+	return length;
+}
+
+/**
+ * @brief Define the movement sequence to be executed on speed runs.
+ *
+ * The path is defined through known walls only. If there is no such path
+ * (i.e.: exploration was interrupted), unknown walls are considered open.
+ *
+ * Out of all the shortest paths, the one with the fastest smooth path is
+ * selected. With time-weighted search, the path follows the time-weighted
+ * distances instead.
+ *
+ * Normal speed runs do not execute this sequence: `run()` and `run_back()`
+ * plan the fastest smooth path through known walls, which may not even be a
+ * shortest one. The sequence is only executed when there is no such path,
+ * by `run()`, and mirrored by `run_back()`. In that case unknown walls are
+ * considered open, which only this sequence can do, so picking the fastest
+ * of the shortest paths still matters.
+ */
+void set_run_sequence(void)
+{
+	int i = 0;
+	int steps = 0;
+	bool pessimistic = true;
+
+	set_search_initial_state();
+	set_target_goal();
+	set_distances_pessimistic();
+	if (search_distance() == MAX_DISTANCE) {
+		pessimistic = false;
+		set_distances();
+		if (time_weighted_search_enabled)
+			set_weighted_distances();
+	} else if (time_weighted_search_enabled) {
+		set_weighted_distances_pessimistic();
+	}
+
+	run_sequence[i++] = 'B';
+	if (!time_weighted_search_enabled)
+		steps = write_shortest_steps(&run_sequence[i],
+					     RUN_SEQUENCE_LEN - i, pessimistic);
+	if (!steps)
+		steps = write_search_steps(&run_sequence[i], pessimistic);
+	i += steps;
 	while (true) {
 		move_search_position(FRONT);
 		if (search_distance() != 0)
@@ -110,22 +608,48 @@ void set_run_sequence(void)
 /**
  * @brief Run from the start to the goal.
  *
+ * The fastest smooth path is planned through known walls. If there is no such
+ * path (e.g.: after an interrupted exploration, when the goal has not been
+ * reached through known walls yet), the run sequence, which considers unknown
+ * walls as open, is smoothed and executed instead.
+ *
+ * The cell and direction where the run stops are kept to plan the run back.
+ *
  * @param[in] force Maximum force to apply on the tires.
  */
 void run(float force)
 {
-	execute_movement_sequence(run_sequence, force, PATH_DIAGONALS);
+	int length;
+	uint16_t costs[MOVE_NONE];
+	struct smooth_step smooth_path[MAX_SMOOTH_PATH_LEN];
+
+	configure_run_costs(force, costs);
+	if (plan_smooth_path(smooth_path, MAX_SMOOTH_PATH_LEN,
+			     RUN_PATH_LANGUAGE, costs)) {
+		execute_smooth_path(smooth_path, force);
+	} else {
+		execute_movement_sequence(run_sequence, force,
+					  RUN_PATH_LANGUAGE);
+		length = strlen(run_sequence);
+		set_search_initial_state();
+		if (length > 3)
+			move_search_steps(&run_sequence[1], length - 3);
+	}
+	run_end_known = true;
+	run_end_position = search_position();
+	run_end_direction = search_direction();
 }
 
 /**
- * @brief Run back from the goal to the start.
+ * @brief Run back the run sequence, mirrored.
  *
  * @param[in] force Maximum force to apply on the tires.
+ * @param[in] language Language to use for the raw-to-smooth translation.
  */
-void run_back(float force)
+static void run_back_sequence(float force, enum path_language language)
 {
 	int length;
-	char run_back[MAZE_AREA];
+	char run_back[RUN_SEQUENCE_LEN];
 	char translation = '\0';
 
 	length = strlen(run_sequence);
@@ -152,60 +676,92 @@ void run_back(float force)
 		run_back[length - i - 1] = translation;
 	}
 	run_back[length] = '\0';
-	execute_movement_sequence(run_back, force, PATH_SAFE);
+	execute_movement_sequence(run_back, force, language);
 }
 
 /**
- * @brief Function to save the maze sequence on EEPROM.
+ * @brief Run back from the goal to the start.
+ *
+ * The fastest smooth path back to the start is planned through known walls,
+ * from where the last run stopped, independently of the run sequence. If
+ * there is no such path, the run sequence is executed mirrored instead.
+ *
+ * Diagonals are only used when the force is up to the one set with
+ * `run_back_diagonals()`.
+ *
+ * @param[in] force Maximum force to apply on the tires.
  */
-void save_maze(void)
+void run_back(float force)
 {
-	uint32_t save_status = 0;
+	uint16_t costs[MOVE_NONE];
+	enum path_language language = PATH_SAFE;
+	struct smooth_step smooth_path[MAX_SMOOTH_PATH_LEN];
 
-	save_status = eeprom_flash_page(FLASH_EEPROM_ADDRESS_MAZE,
-					(uint8_t *)run_sequence, MAZE_AREA);
+	if (force <= run_back_diagonals_force)
+		language = PATH_DIAGONALS;
+	if (run_end_known) {
+		set_search_state(run_end_position, -run_end_direction);
+		set_target_cell(0);
+		set_distances();
+		configure_run_costs(force, costs);
+		if (plan_smooth_path_to_target(smooth_path,
+					       MAX_SMOOTH_PATH_LEN, language,
+					       costs)) {
+			execute_smooth_path(smooth_path, force);
+			run_end_known = false;
+			return;
+		}
+	}
+	run_back_sequence(force, language);
+	run_end_known = false;
+}
 
-	if (save_status != RESULT_OK)
-		LOG_ERROR("EEPROM save error %" PRIu32, save_status);
+/**
+ * @brief Save the maze walls on EEPROM.
+ */
+void save_maze(void)
+{
+	write_maze_record();
 }
 
 /**
- * @brief Function to load the maze sequence from EEPROM to static on RAM.
+ * @brief Load the maze walls from EEPROM and plan the run sequence.
  */
 void load_maze(void)
 {
-	eeprom_read_data(FLASH_EEPROM_ADDRESS_MAZE, MAZE_AREA,
-			 (uint8_t *)run_sequence);
+	struct maze_record record;
+
+	if (read_maze_record(&record) < 0) {
+		LOG_ERROR("No valid maze saved on EEPROM");
+		return;
+	}
+	restore_walls_snapshot(&record.walls);
+	set_run_sequence();
 }
 
 /**
- * @brief Function to reset the maze sequence on EEPROM.
+ * @brief Function to reset the maze on EEPROM.
  */
 void reset_maze(void)
 {
+	int slot;
 	uint32_t erase_status = 0;
 
-	erase_status = eeprom_erase_page(FLASH_EEPROM_ADDRESS_MAZE);
-	if (erase_status != RESULT_OK)
-		LOG_ERROR("EEPROM reset error %" PRIu32, erase_status);
+	for (slot = 0; slot < MAZE_RECORD_SLOTS; slot++) {
+		erase_status = eeprom_erase_page(maze_record_addresses[slot]);
+		if (erase_status != RESULT_OK)
+			LOG_ERROR("EEPROM reset error %" PRIu32, erase_status);
+	}
 }
 
 /**
- * @brief Function to check if the maze sequence is saved on EEPROM.
+ * @brief Function to check if a valid maze is saved on EEPROM.
  *
  *@return bool
  */
 bool maze_is_saved(void)
 {
-	uint8_t maze_sample[EEPROM_NUM_BYTES_ERASED_CHECKED];
-
-	eeprom_read_data(FLASH_EEPROM_ADDRESS_MAZE,
-			 EEPROM_NUM_BYTES_ERASED_CHECKED, maze_sample);
-
-	for (uint8_t iter = 0; iter < EEPROM_NUM_BYTES_ERASED_CHECKED; iter++) {
-		if (maze_sample[iter] != EEPROM_BYTE_ERASED_VALUE)
-			return true;
-	}
+	struct maze_record record;
 
-	return false;
+	return read_maze_record(&record) >= 0;
 }
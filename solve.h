@@ -4,13 +4,18 @@
 #include "mmlib/logging.h"
 #include "mmlib/move.h"
 #include "mmlib/path.h"
+#include "mmlib/planner.h"
 #include "mmlib/search.h"
 #include "mmlib/walls.h"
 
 #include "eeprom.h"
 #include "setup.h"
 
+void time_weighted_search(bool value);
+void fast_traversal(float force);
+void run_back_diagonals(float force);
 void explore(float force);
+void resume_exploration(float force);
 #ifdef MMSIM_SIMULATION
 void send_state(void);
 #endif
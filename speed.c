@@ -1,13 +1,18 @@
 #include "speed.h"
 
+#define TURN_INTEGRATION_STEPS 64
+#define TURN_SOLVER_ITERATIONS 24
+
 /**
  * Speed module static variables.
  *
  * - Maximum force applied on the tires.
  * - Maximum linear speed.
+ * - Maximum linear jerk.
  */
 static volatile float max_force;
 static volatile float max_linear_speed;
+static volatile float max_linear_jerk = SEARCH_LINEAR_JERK;
 
 /**
  * Parameters that define a turn.
@@ -34,20 +39,40 @@ struct turn_parameters {
  * This speed is calculated so that the search speed in long straight lines
  * is always constant.
  *
+ * The jerk-limited braking distance has no simple inverse, so the speed is
+ * found with a bisection. The constant deceleration solution, which ignores
+ * the jerk, is used as the upper bound.
+ *
  * @param[in] force Maximum force to apply while searching.
  *
  * @return The calculated search linear speed.
  */
 static float _calculate_search_linear_speed(float force)
 {
+	int i;
+	float speed;
+	float low_speed;
+	float high_speed;
 	float turn_velocity;
 	float break_margin;
 
 	turn_velocity = get_move_turn_linear_speed(MOVE_LEFT, force);
 	break_margin = get_move_turn_before(MOVE_LEFT);
 	break_margin -= turn_velocity * SEARCH_REACTION_TIME;
-	return sqrt(turn_velocity * turn_velocity +
-		    2 * get_linear_deceleration() * break_margin);
+	low_speed = turn_velocity;
+	high_speed = sqrt(turn_velocity * turn_velocity +
+			  2 * get_linear_deceleration() * break_margin);
+	if (high_speed <= low_speed)
+		return high_speed;
+	for (i = 0; i < 20; i++) {
+		speed = (low_speed + high_speed) / 2;
+		if (get_speed_change_distance(speed, turn_velocity) >
+		    break_margin)
+			high_speed = speed;
+		else
+			low_speed = speed;
+	}
+	return low_speed;
 }
 
 /**
@@ -63,16 +88,21 @@ static float _calculate_search_linear_speed(float force)
 void kinematic_configuration(float force, bool run)
 {
 	max_force = force;
-	if (run)
+	generate_turn_variants();
+	if (run) {
+		max_linear_jerk = RUN_LINEAR_JERK;
 		max_linear_speed = get_linear_speed_limit();
-	else
+	} else {
+		max_linear_jerk = SEARCH_LINEAR_JERK;
 		max_linear_speed = _calculate_search_linear_speed(force);
+	}
 }
 
 // clang-format off
 struct turn_parameters turns[] = {
     [MOVE_LEFT] = {0.01700, 0.01700, 0.04921, 0.06042, 0.00037, -1},
     [MOVE_RIGHT] = {0.01700, 0.01700, 0.04921, 0.06042, 0.00037, 1},
+    [MOVE_BACK] = {0., 0., 0., 0., 0., 1},
     [MOVE_LEFT_90] = {-0.06272, -0.06272, 0.13000, 0.06042, 0.12728, -1},
     [MOVE_RIGHT_90] = {-0.06272, -0.06272, 0.13000, 0.06042, 0.12728, 1},
     [MOVE_LEFT_180] = {-0.04500, -0.04500, 0.08882, 0.06042, 0.20211, -1},
@@ -87,9 +117,389 @@ struct turn_parameters turns[] = {
     [MOVE_RIGHT_FROM_135] = {0.03642, -0.03813, 0.08000, 0.06042, 0.11157, 1},
     [MOVE_LEFT_DIAGONAL] = {0.03888, 0.03888, 0.06500, 0.06042, 0.02518, -1},
     [MOVE_RIGHT_DIAGONAL] = {0.03888, 0.03888, 0.06500, 0.06042, 0.02518, 1},
+    [MOVE_LEFT_90_LARGE] = {-0.11000, 0.07000, 0.17748, 0.06042, 0.20185, -1},
+    [MOVE_RIGHT_90_LARGE] = {-0.11000, 0.07000, 0.17748, 0.06042, 0.20185, 1},
+    [MOVE_LEFT_180_LARGE] = {-0.07000, -0.07000, 0.17942, 0.06042, 0.48674, -1},
+    [MOVE_RIGHT_180_LARGE] = {-0.07000, -0.07000, 0.17942, 0.06042, 0.48674, 1},
 };
 // clang-format on
 
+/**
+ * Larger radius variants of each turn, generated from the `turns[]` table.
+ *
+ * Variant `i` is stored at index `i - 1`, as variant zero is the turn in the
+ * `turns[]` table. Variants with a zero radius are not available.
+ */
+static struct turn_parameters turn_variants[MOVE_NONE][TURN_VARIANTS - 1];
+static bool turn_variants_generated;
+
+/**
+ * Pose at which a turn exits, relative to where it enters.
+ *
+ * The entry is at the origin, heading along the X axis, with the Y axis
+ * pointing towards the side of the turn. The exit pose includes the straight
+ * distances travelled before and after the curve.
+ *
+ * - Heading change, in radians
+ * - Exit position along the X axis, in meters
+ * - Exit position along the Y axis, in meters
+ */
+struct turn_exit {
+	float angle;
+	float x;
+	float y;
+};
+
+/**
+ * @brief Get the pose at which a turn must exit, given its maze geometry.
+ *
+ * @param[in] turn_type Turn type.
+ *
+ * @return The exit pose, with a zero heading change if the movement is not a
+ * speed turn.
+ */
+static struct turn_exit _get_turn_exit(enum movement turn_type)
+{
+	struct turn_exit exit = {0., 0., 0.};
+
+	switch (turn_type) {
+	case MOVE_LEFT:
+	case MOVE_RIGHT:
+	case MOVE_LEFT_90:
+	case MOVE_RIGHT_90:
+		exit.angle = PI / 2;
+		exit.x = CELL_DIMENSION / 2;
+		exit.y = CELL_DIMENSION / 2;
+		break;
+	case MOVE_BACK:
+		exit.angle = PI;
+		break;
+	case MOVE_LEFT_180:
+	case MOVE_RIGHT_180:
+		exit.angle = PI;
+		exit.y = CELL_DIMENSION;
+		break;
+	case MOVE_LEFT_TO_45:
+	case MOVE_RIGHT_TO_45:
+		exit.angle = PI / 4;
+		exit.x = CELL_DIMENSION / 2;
+		exit.y = CELL_DIMENSION / 2;
+		break;
+	case MOVE_LEFT_FROM_45:
+	case MOVE_RIGHT_FROM_45:
+		exit.angle = PI / 4;
+		exit.x = CELL_DIAGONAL;
+		break;
+	case MOVE_LEFT_TO_135:
+	case MOVE_RIGHT_TO_135:
+		exit.angle = 3 * PI / 4;
+		exit.y = CELL_DIMENSION;
+		break;
+	case MOVE_LEFT_FROM_135:
+	case MOVE_RIGHT_FROM_135:
+		exit.angle = 3 * PI / 4;
+		exit.x = CELL_DIAGONAL;
+		exit.y = CELL_DIAGONAL;
+		break;
+	case MOVE_LEFT_DIAGONAL:
+	case MOVE_RIGHT_DIAGONAL:
+		exit.angle = PI / 2;
+		exit.x = CELL_DIAGONAL;
+		exit.y = CELL_DIAGONAL;
+		break;
+	case MOVE_LEFT_90_LARGE:
+	case MOVE_RIGHT_90_LARGE:
+		exit.angle = PI / 2;
+		exit.x = CELL_DIMENSION / 2;
+		exit.y = 3 * CELL_DIMENSION / 2;
+		break;
+	case MOVE_LEFT_180_LARGE:
+	case MOVE_RIGHT_180_LARGE:
+		exit.angle = PI;
+		exit.y = 2 * CELL_DIMENSION;
+		break;
+	default:
+		break;
+	}
+	return exit;
+}
+
+/**
+ * @brief Get the heading after travelling some distance along a turn curve.
+ *
+ * The curvature follows the angular speed profile of `speed_turn()`: a
+ * sinusoidal transition up to `1 / radius`, a constant arc and a sinusoidal
+ * transition back to zero.
+ *
+ * @param[in] progress Distance travelled along the curve, in meters.
+ * @param[in] radius Curve minimum radius.
+ * @param[in] transition Duration, in meters, of each transition.
+ * @param[in] arc Duration, in meters, of the constant curvature phase.
+ */
+static float _get_turn_heading(float progress, float radius, float transition,
+			       float arc)
+{
+	float ramp = 2 * transition / (PI * radius);
+
+	if (progress < transition)
+		return ramp * (1 - cos(progress / transition * PI / 2));
+	if (progress < transition + arc)
+		return ramp + (progress - transition) / radius;
+	progress -= transition + arc;
+	return ramp + arc / radius +
+	       ramp * sin(progress / transition * PI / 2);
+}
+
+/**
+ * @brief Integrate the displacement along the beginning of a turn curve.
+ *
+ * Simpson's rule is used, as the heading along the curve is smooth.
+ *
+ * @param[in] radius Curve minimum radius.
+ * @param[in] transition Duration, in meters, of each transition.
+ * @param[in] arc Duration, in meters, of the constant curvature phase.
+ * @param[in] length Distance along the curve up to which to integrate.
+ * @param[out] x Displacement along the entry heading.
+ * @param[out] y Displacement towards the side of the turn.
+ */
+static void _integrate_turn_until(float radius, float transition, float arc,
+				  float length, float *x, float *y)
+{
+	int i;
+	int weight;
+	float heading;
+	float step = length / TURN_INTEGRATION_STEPS;
+
+	*x = 0.;
+	*y = 0.;
+	for (i = 0; i <= TURN_INTEGRATION_STEPS; i++) {
+		heading = _get_turn_heading(i * step, radius, transition, arc);
+		if (i == 0 || i == TURN_INTEGRATION_STEPS)
+			weight = 1;
+		else
+			weight = i % 2 ? 4 : 2;
+		*x += weight * cos(heading);
+		*y += weight * sin(heading);
+	}
+	*x *= step / 3;
+	*y *= step / 3;
+}
+
+/**
+ * @brief Integrate the displacement along a turn curve.
+ *
+ * @param[in] radius Curve minimum radius.
+ * @param[in] transition Duration, in meters, of each transition.
+ * @param[in] arc Duration, in meters, of the constant curvature phase.
+ * @param[out] x Displacement along the entry heading.
+ * @param[out] y Displacement towards the side of the turn.
+ */
+static void _integrate_turn(float radius, float transition, float arc,
+			    float *x, float *y)
+{
+	_integrate_turn_until(radius, transition, arc, 2 * transition + arc, x,
+			      y);
+}
+
+/**
+ * @brief Calculate the parameters of a turn for a given radius and transition.
+ *
+ * The arc is set to complete the heading change of the turn, and the
+ * displacement of the resulting curve is integrated. The straight distances
+ * before and after the curve are then set so that the turn exits exactly at
+ * the pose defined by the maze geometry.
+ *
+ * U-turns are special: the straight distances cannot correct the lateral
+ * displacement, so the transition is adjusted instead for the curve to be as
+ * wide as the exit requires. The straight distances are kept in that case.
+ *
+ * The U-turn inside a dead end (`MOVE_BACK`) cannot exit at its pose either,
+ * which is the entry of the cell. Its curve is placed so that it reaches the
+ * center of the cell, as far as an in-place turn would, and it exits with a
+ * straight back to the entry of the cell. The lateral displacement of the
+ * curve is left to be absorbed by the side walls control during that exit
+ * straight, as dead ends always have both side walls.
+ *
+ * The sign of the turn is kept. The turn is only modified on success.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] radius Curve minimum radius.
+ * @param[in] transition Duration, in meters, of each transition.
+ * @param[in,out] turn Turn parameters to update.
+ *
+ * @return Whether the turn could be calculated.
+ */
+static bool _calculate_turn(enum movement turn_type, float radius,
+			    float transition, struct turn_parameters *turn)
+{
+	int i;
+	float x;
+	float y;
+	float arc;
+	float low;
+	float high;
+	float after;
+	struct turn_exit exit = _get_turn_exit(turn_type);
+
+	if (exit.angle == 0. || radius <= 0. || transition <= 0.)
+		return false;
+	if (turn_type == MOVE_BACK) {
+		arc = exit.angle * radius - 4 * transition / PI;
+		if (arc < 0.)
+			return false;
+		_integrate_turn_until(radius, transition, arc,
+				      transition + arc / 2, &x, &y);
+		if (x > CELL_DIMENSION / 2)
+			return false;
+		turn->before = CELL_DIMENSION / 2 - x;
+		_integrate_turn(radius, transition, arc, &x, &y);
+		turn->after = turn->before + x;
+		turn->radius = radius;
+		turn->transition = transition;
+		turn->arc = arc;
+		return true;
+	}
+	if (fabs(sin(exit.angle)) < 0.01) {
+		low = 0.;
+		high = exit.angle * radius * PI / 4;
+		if (2 * radius >= exit.y)
+			return false;
+		_integrate_turn(radius, high, 0., &x, &y);
+		if (y < exit.y)
+			return false;
+		for (i = 0; i < TURN_SOLVER_ITERATIONS; i++) {
+			transition = (low + high) / 2;
+			arc = exit.angle * radius - 4 * transition / PI;
+			_integrate_turn(radius, transition, arc, &x, &y);
+			if (y > exit.y)
+				high = transition;
+			else
+				low = transition;
+		}
+		transition = (low + high) / 2;
+		turn->radius = radius;
+		turn->transition = transition;
+		turn->arc = exit.angle * radius - 4 * transition / PI;
+		return true;
+	}
+	arc = exit.angle * radius - 4 * transition / PI;
+	if (arc < 0.)
+		return false;
+	_integrate_turn(radius, transition, arc, &x, &y);
+	after = (exit.y - y) / sin(exit.angle);
+	turn->before = exit.x - x - after * cos(exit.angle);
+	turn->after = after;
+	turn->radius = radius;
+	turn->transition = transition;
+	turn->arc = arc;
+	return true;
+}
+
+/**
+ * @brief Generate the larger radius variants of a turn.
+ *
+ * Each variant multiplies the radius of the previous one by
+ * `TURN_VARIANT_RADIUS_GAIN`, keeping the transition. Variants that do not
+ * fit the maze geometry are left unavailable.
+ *
+ * @param[in] turn_type Turn type.
+ */
+static void _generate_turn_variants(enum movement turn_type)
+{
+	int i;
+	float radius = turns[turn_type].radius;
+	struct turn_parameters *variant;
+
+	for (i = 0; i < TURN_VARIANTS - 1; i++) {
+		variant = &turn_variants[turn_type][i];
+		*variant = turns[turn_type];
+		radius *= TURN_VARIANT_RADIUS_GAIN;
+		if (!_calculate_turn(turn_type, radius,
+				     turns[turn_type].transition, variant))
+			variant->radius = 0.;
+	}
+}
+
+/**
+ * @brief Generate the parameters of a turn for a given radius and transition.
+ *
+ * See `_calculate_turn()` for details. The larger radius variants of the turn
+ * are generated again too.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] radius Curve minimum radius.
+ * @param[in] transition Duration, in meters, of each transition.
+ *
+ * @return Whether the turn could be generated.
+ */
+bool generate_turn(enum movement turn_type, float radius, float transition)
+{
+	if (!_calculate_turn(turn_type, radius, transition, &turns[turn_type]))
+		return false;
+	_generate_turn_variants(turn_type);
+	return true;
+}
+
+/**
+ * @brief Generate the larger radius variants of all turns.
+ *
+ * The U-turn taken inside dead ends, which is not defined in the `turns[]`
+ * table, is generated first. Variants are only generated once, as
+ * `generate_turn()` keeps them up to date afterwards.
+ */
+void generate_turn_variants(void)
+{
+	int turn_type;
+
+	if (turn_variants_generated)
+		return;
+	if (!generate_turn(MOVE_BACK, U_TURN_RADIUS, U_TURN_TRANSITION))
+		LOG_ERROR("Unable to generate the U-turn!");
+	for (turn_type = 0; turn_type < MOVE_NONE; turn_type++)
+		if (_get_turn_exit(turn_type).angle != 0.)
+			_generate_turn_variants(turn_type);
+	turn_variants_generated = true;
+}
+
+/**
+ * @brief Get the parameters of a turn variant.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] variant Turn variant, where zero is the tightest one.
+ */
+static struct turn_parameters *_get_turn(enum movement turn_type, int variant)
+{
+	if (variant == 0)
+		return &turns[turn_type];
+	return &turn_variants[turn_type][variant - 1];
+}
+
+/**
+ * @brief Select the largest turn variant that fits the available straights.
+ *
+ * Larger variants have a larger radius, and thus a higher turn linear speed,
+ * but require longer straight distances before and after the curve.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] before Straight distance available before the turn.
+ * @param[in] after Straight distance available after the turn.
+ *
+ * @return The selected variant, which is zero if no larger one fits.
+ */
+int get_turn_variant(enum movement turn_type, float before, float after)
+{
+	int variant;
+	struct turn_parameters *turn;
+
+	for (variant = TURN_VARIANTS - 1; variant > 0; variant--) {
+		turn = _get_turn(turn_type, variant);
+		if (turn->radius > 0. && before + turn->before >= 0. &&
+		    after + turn->after >= 0.)
+			return variant;
+	}
+	return 0;
+}
+
 float get_max_force(void)
 {
 	return max_force;
@@ -110,6 +520,96 @@ float get_linear_deceleration(void)
 	return 2 * max_force / MOUSE_MASS;
 }
 
+float get_linear_jerk(void)
+{
+	return max_linear_jerk;
+}
+
+void set_linear_jerk(float value)
+{
+	max_linear_jerk = value;
+}
+
+/**
+ * @brief Time required to change the linear speed, in seconds.
+ *
+ * The speed profile is jerk-limited: the acceleration ramps up at the maximum
+ * jerk, stays at its maximum if the speed change is large enough to reach it
+ * and ramps back down to zero.
+ *
+ * @param[in] initial Initial linear speed, with zero acceleration.
+ * @param[in] final Final linear speed.
+ */
+float get_speed_change_time(float initial, float final)
+{
+	float change = fabsf(final - initial);
+	float acceleration = final > initial ? get_linear_acceleration()
+					     : get_linear_deceleration();
+
+	if (change * max_linear_jerk < acceleration * acceleration)
+		return 2 * sqrt(change / max_linear_jerk);
+	return change / acceleration + acceleration / max_linear_jerk;
+}
+
+/**
+ * @brief Distance required to change the linear speed, in meters.
+ *
+ * The jerk-limited profile is symmetric, so the average speed is the average
+ * of the initial and the final speeds.
+ *
+ * @param[in] initial Initial linear speed, with zero acceleration.
+ * @param[in] final Final linear speed.
+ */
+float get_speed_change_distance(float initial, float final)
+{
+	return (initial + final) / 2 * get_speed_change_time(initial, final);
+}
+
+/**
+ * @brief Highest speed reachable within a distance, with jerk-limited changes.
+ *
+ * The same profile is followed when accelerating from the given speed and
+ * when braking down to it, so this is both the speed reachable accelerating
+ * from `speed` and the highest speed that can be braked to `speed` within the
+ * distance.
+ *
+ * When the maximum acceleration is reached the distance is a quadratic
+ * function of the speed change. Otherwise it is a depressed cubic of the
+ * square root of the speed change, solved with Cardano's formula written in
+ * a form that avoids cancellation.
+ *
+ * @param[in] speed Known speed, with zero acceleration.
+ * @param[in] distance Available distance, in meters.
+ * @param[in] acceleration Maximum acceleration, or deceleration, to apply.
+ */
+float get_reachable_speed(float speed, float distance, float acceleration)
+{
+	float p;
+	float q;
+	float root;
+	float linear;
+	float change = acceleration * acceleration / max_linear_jerk;
+
+	if (distance <= 0.)
+		return speed;
+	if ((speed + change / 2) * 2 * acceleration / max_linear_jerk <=
+	    distance) {
+		linear = speed / acceleration +
+			 acceleration / (2 * max_linear_jerk);
+		return speed +
+		       acceleration *
+			   (-linear +
+			    sqrt(linear * linear -
+				 2 * (speed / max_linear_jerk -
+				      distance / acceleration)));
+	}
+	p = 2 * speed;
+	q = distance * sqrt(max_linear_jerk);
+	root = cbrt(q / 2 + sqrt(q * q / 4 + p * p * p / 27));
+	root = q / (root * root + p / 3 + p * p / (9 * root * root));
+	return speed + root * root;
+}
+
 float get_max_linear_speed(void)
 {
 	return max_linear_speed;
@@ -120,6 +620,54 @@ void set_max_linear_speed(float value)
 	max_linear_speed = value;
 }
 
+/**
+ * @brief Add a speed turn variant at a given linear speed to the motion queue.
+ *
+ * The angular speed profile is scaled with the linear speed, so the turn
+ * geometry is kept for any speed up to the turn linear speed.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] variant Turn variant.
+ * @param[in] linear_velocity Linear speed at which to turn.
+ */
+void enqueue_speed_turn_variant(enum movement turn_type, int variant,
+				float linear_velocity)
+{
+	struct turn_parameters turn = *_get_turn(turn_type, variant);
+	struct motion motion = {
+	    .type = MOTION_SPEED_TURN,
+	    .controls = 0,
+	    .max_angular_velocity = turn.sign * linear_velocity / turn.radius,
+	    .transition = turn.transition,
+	    .arc = turn.arc,
+	};
+
+	enqueue_motion(motion);
+}
+
+/**
+ * @brief Add a speed turn at a given linear speed to the motion queue.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] linear_velocity Linear speed at which to turn.
+ */
+void enqueue_speed_turn(enum movement turn_type, float linear_velocity)
+{
+	enqueue_speed_turn_variant(turn_type, 0, linear_velocity);
+}
+
+/**
+ * @brief Execute a speed turn at a given linear speed.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] linear_velocity Linear speed at which to turn.
+ */
+void parametric_speed_turn(enum movement turn_type, float linear_velocity)
+{
+	enqueue_speed_turn(turn_type, linear_velocity);
+	wait_motion_queue_empty();
+}
+
 /**
  * @brief Execute a speed turn.
  *
@@ -128,36 +676,8 @@ void set_max_linear_speed(float value)
  */
 void speed_turn(enum movement turn_type, float force)
 {
-	int32_t start;
-	int32_t current;
-	float travelled;
-	float linear_velocity;
-	float angular_velocity;
-	float max_angular_velocity;
-	float factor;
-	struct turn_parameters turn = turns[turn_type];
-
-	linear_velocity = get_move_turn_linear_speed(turn_type, force);
-	max_angular_velocity = turn.sign * linear_velocity / turn.radius;
-
-	disable_walls_control();
-	start = get_encoder_average_micrometers();
-	while (true) {
-		current = get_encoder_average_micrometers();
-		travelled = (float)(current - start) / MICROMETERS_PER_METER;
-		if (travelled >= 2 * turn.transition + turn.arc)
-			break;
-		angular_velocity = max_angular_velocity;
-		if (travelled < turn.transition) {
-			factor = travelled / turn.transition;
-			angular_velocity *= sin(factor * PI / 2);
-		} else if (travelled >= turn.transition + turn.arc) {
-			factor = (travelled - turn.arc) / turn.transition;
-			angular_velocity *= sin(factor * PI / 2);
-		}
-		set_ideal_angular_speed(angular_velocity);
-	}
-	set_ideal_angular_speed(0);
+	parametric_speed_turn(turn_type,
+			      get_move_turn_linear_speed(turn_type, force));
 }
 
 /**
@@ -172,6 +692,20 @@ float get_move_turn_before(enum movement turn_type)
 	return turns[turn_type].before;
 }
 
+/**
+ * @brief Get the straight distance that a turn variant adds before a straight
+ * movement.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] variant Turn variant.
+ *
+ * @return The added distance.
+ */
+float get_turn_variant_before(enum movement turn_type, int variant)
+{
+	return _get_turn(turn_type, variant)->before;
+}
+
 /**
  * @brief Get the straight distance that a turn adds after a straight movement.
  *
@@ -184,6 +718,20 @@ float get_move_turn_after(enum movement turn_type)
 	return turns[turn_type].after;
 }
 
+/**
+ * @brief Get the straight distance that a turn variant adds after a straight
+ * movement.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] variant Turn variant.
+ *
+ * @return The added distance.
+ */
+float get_turn_variant_after(enum movement turn_type, int variant)
+{
+	return _get_turn(turn_type, variant)->after;
+}
+
 /**
  * @brief Get the expected linear speed at which to turn.
  *
@@ -196,3 +744,100 @@ float get_move_turn_linear_speed(enum movement turn_type, float force)
 {
 	return sqrt(force * 2 * turns[turn_type].radius / MOUSE_MASS);
 }
+
+/**
+ * @brief Get the expected linear speed at which to turn, for a turn variant.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] variant Turn variant.
+ * @param[in] force Maximum force to apply while turning.
+ *
+ * @return The calculated speed.
+ */
+float get_turn_variant_linear_speed(enum movement turn_type, int variant,
+				    float force)
+{
+	return sqrt(force * 2 * _get_turn(turn_type, variant)->radius /
+		    MOUSE_MASS);
+}
+
+/**
+ * @brief Get the expected time to complete a turn, in seconds.
+ *
+ * Includes the straight distances added before and after the turn, assuming
+ * they are travelled at the turn linear speed.
+ *
+ * @param[in] turn_type Turn type.
+ * @param[in] force Maximum force to apply while turning.
+ *
+ * @return The calculated time.
+ */
+float get_move_turn_time(enum movement turn_type, float force)
+{
+	struct turn_parameters turn = turns[turn_type];
+
+	return (turn.before + 2 * turn.transition + turn.arc + turn.after) /
+	       get_move_turn_linear_speed(turn_type, force);
+}
+
+/**
+ * @brief Estimate the time to execute a smooth path movement, in seconds.
+ *
+ * Straight movements and the straight distances added before and after turns
+ * are assumed to be travelled at the maximum linear speed. Turns also include
+ * the time lost braking to the turn linear speed and accelerating back, which
+ * is `t * (v_max - v) / (2 * v_max)` for each of both phases, where `t` is the
+ * duration of the jerk-limited speed change.
+ *
+ * @param[in] move Smooth path movement.
+ * @param[in] force Maximum force to apply on the tires.
+ *
+ * @return The estimated time.
+ */
+float get_move_time(enum movement move, float force)
+{
+	float turn_speed;
+	float speed_loss;
+	struct turn_parameters turn;
+	float max_speed = get_max_linear_speed();
+
+	if (move == MOVE_FRONT)
+		return CELL_DIMENSION / max_speed;
+	if (move == MOVE_DIAGONAL)
+		return CELL_DIAGONAL / max_speed;
+	turn = turns[move];
+	turn_speed = get_move_turn_linear_speed(move, force);
+	if (turn_speed > max_speed)
+		turn_speed = max_speed;
+	speed_loss = max_speed - turn_speed;
+	return (turn.before + turn.after) / max_speed +
+	       (2 * turn.transition + turn.arc) / turn_speed +
+	       speed_loss / (2 * max_speed) *
+		   (get_speed_change_time(max_speed, turn_speed) +
+		    get_speed_change_time(turn_speed, max_speed));
+}
+
+/**
+ * @brief Estimate the time to execute a smooth path, in seconds.
+ *
+ * Each movement is estimated with `get_move_time()`, multiplied by the number
+ * of times it is repeated. The start and the stop are not accounted for.
+ *
+ * @param[in] smooth_path Sequence of smooth movements.
+ * @param[in] force Maximum force to apply on the tires.
+ *
+ * @return The estimated time.
+ */
+float get_smooth_path_time(struct smooth_step *smooth_path, float force)
+{
+	float time = 0.;
+
+	for (; smooth_path->movement != MOVE_END; smooth_path++) {
+		if (smooth_path->movement == MOVE_START ||
+		    smooth_path->movement == MOVE_STOP)
+			continue;
+		time += smooth_path->count *
+			get_move_time(smooth_path->movement, force);
+	}
+	return time;
+}
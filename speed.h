@@ -5,23 +5,84 @@
 
 #include "mmlib/common.h"
 #include "mmlib/control.h"
+#include "mmlib/motion.h"
 #include "mmlib/move.h"
 #include "mmlib/path.h"
 
 #include "config.h"
 #include "setup.h"
 
+/**
+ * Maximum linear jerk, in meters per second cubed, for each phase.
+ *
+ * Limiting the jerk makes the linear acceleration ramp up and down instead of
+ * jumping between zero and its maximum, which reduces wheel slip and gyroscope
+ * noise. The search phase uses a lower jerk, for a smoother search.
+ */
+#ifndef SEARCH_LINEAR_JERK
+#define SEARCH_LINEAR_JERK 200.
+#endif
+#ifndef RUN_LINEAR_JERK
+#define RUN_LINEAR_JERK 400.
+#endif
+
+/**
+ * Number of radius variants of each turn, including the one in the turns
+ * table, and radius ratio between consecutive variants.
+ *
+ * Larger variants are faster, but require longer straights around the turn.
+ */
+#ifndef TURN_VARIANTS
+#define TURN_VARIANTS 3
+#endif
+#ifndef TURN_VARIANT_RADIUS_GAIN
+#define TURN_VARIANT_RADIUS_GAIN 1.3
+#endif
+
+/**
+ * Curve minimum radius and transition, in meters, of the U-turn taken while
+ * moving inside a dead end.
+ *
+ * The curve ends displaced sideways about twice its radius, which the side
+ * walls control absorbs after the turn, so the radius is kept small.
+ */
+#ifndef U_TURN_RADIUS
+#define U_TURN_RADIUS 0.012
+#endif
+#ifndef U_TURN_TRANSITION
+#define U_TURN_TRANSITION 0.02
+#endif
+
 float get_max_force(void);
 void set_max_force(float value);
 float get_linear_acceleration(void);
 float get_linear_deceleration(void);
+float get_linear_jerk(void);
+void set_linear_jerk(float value);
 float get_max_linear_speed(void);
 void set_max_linear_speed(float value);
 void kinematic_configuration(float force, bool run);
+float get_speed_change_time(float initial, float final);
+float get_speed_change_distance(float initial, float final);
+float get_reachable_speed(float speed, float distance, float acceleration);
+bool generate_turn(enum movement turn_type, float radius, float transition);
+void generate_turn_variants(void);
+int get_turn_variant(enum movement turn_type, float before, float after);
 float get_move_turn_before(enum movement move);
+float get_turn_variant_before(enum movement turn_type, int variant);
 float get_move_turn_after(enum movement move);
+float get_turn_variant_after(enum movement turn_type, int variant);
 float get_move_turn_linear_speed(enum movement turn_type, float force);
+float get_turn_variant_linear_speed(enum movement turn_type, int variant,
+				    float force);
+float get_move_turn_time(enum movement turn_type, float force);
+float get_move_time(enum movement move, float force);
+float get_smooth_path_time(struct smooth_step *smooth_path, float force);
 
+void enqueue_speed_turn_variant(enum movement turn_type, int variant,
+				float linear_velocity);
+void enqueue_speed_turn(enum movement turn_type, float linear_velocity);
+void parametric_speed_turn(enum movement turn_type, float linear_velocity);
 void speed_turn(enum movement turn_type, float force);
 
 #endif /* __SPEED_H */
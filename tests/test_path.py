@@ -15,20 +15,31 @@ def interface():
     yield from yield_cffi('./path')
 
 
-def smooth_path(interface, sharp, language):
+def smooth_steps(interface, sharp, language, size=30):
     """
-    Generate a smoothed path using the specified path language.
+    Generate a smoothed path using the specified path language, as a list of
+    (movement, count) steps.
     """
     ffi, lib = interface
-    result = ffi.new('enum movement destination[30]')
+    result = ffi.new('struct smooth_step destination[%d]' % size)
     language = getattr(lib, language)
-    lib.make_smooth_path(sharp.encode('ascii'), result, language)
-    result = stringify_enums(result, ffi, 'enum movement')
-    result = [x[5:] for x in result]
-    return result[:result.index('END')]
+    assert lib.make_smooth_path(sharp.encode('ascii'), result, size, language)
+    movements = stringify_enums([x.movement for x in result], ffi,
+                                'enum movement')
+    steps = [(x[5:], step.count) for x, step in zip(movements, result)]
+    return steps[:[x for x, _ in steps].index('END')]
+
+
+def smooth_path(interface, sharp, language):
+    """
+    Generate a smoothed path using the specified path language.
+    """
+    steps = smooth_steps(interface, sharp, language)
+    return [movement for movement, count in steps for _ in range(count)]
 
 
-@pytest.mark.parametrize('language', ['PATH_SAFE', 'PATH_DIAGONALS'])
+@pytest.mark.parametrize('language', ['PATH_SAFE', 'PATH_DIAGONALS',
+                                      'PATH_DIAGONALS_FAST'])
 @pytest.mark.parametrize('sharp', [
     '', 'F', 'FF', 'FLF', 'FRF', 'FLLF', 'FLRF', 'FRRF', 'FRLF', 'FRFLLF',
 ])
@@ -46,7 +57,8 @@ def test_path_smoother_start_stop(interface, sharp, language):
         smooth_path(interface, 'B' + sharp + 'S', language)
 
 
-@pytest.mark.parametrize('language', ['PATH_SAFE', 'PATH_DIAGONALS'])
+@pytest.mark.parametrize('language', ['PATH_SAFE', 'PATH_DIAGONALS',
+                                      'PATH_DIAGONALS_FAST'])
 @pytest.mark.parametrize('sharp,smooth', [
     ('F', ['FRONT']),
     ('FF', ['FRONT', 'FRONT']),
@@ -146,3 +158,62 @@ def test_path_smoother_diagonals(interface, sharp, smooth):
     Test correct path smoothing with the diagonals language.
     """
     assert smooth == smooth_path(interface, sharp, 'PATH_DIAGONALS')
+
+
+@pytest.mark.parametrize('sharp,smooth', [
+    ('FLFF', ['FRONT', 'LEFT_90_LARGE', 'FRONT']),
+    ('FRFF', ['FRONT', 'RIGHT_90_LARGE', 'FRONT']),
+    ('FLFLF', ['FRONT', 'LEFT_180_LARGE', 'FRONT']),
+    ('FRFRF', ['FRONT', 'RIGHT_180_LARGE', 'FRONT']),
+    ('FFLFFLFF', ['FRONT', 'FRONT', 'LEFT_90_LARGE', 'FRONT',
+                  'LEFT_90_LARGE', 'FRONT']),
+    ('FLFRF', ['FRONT', 'LEFT_90', 'FRONT', 'RIGHT_90', 'FRONT']),
+    ('FLFLLF', ['FRONT', 'LEFT_90', 'FRONT', 'LEFT_180', 'FRONT']),
+    ('FLRFF', ['FRONT', 'LEFT_TO_45', 'RIGHT_FROM_45', 'FRONT', 'FRONT']),
+    ('FRLLRF',
+     ['FRONT', 'RIGHT_TO_45', 'LEFT_DIAGONAL', 'RIGHT_FROM_45', 'FRONT']),
+], ids=[
+    'Large 90-degrees left turn',
+    'Large 90-degrees right turn',
+    'Large 180-degrees left turn',
+    'Large 180-degrees right turn',
+    'Consecutive large 90-degrees turns',
+    'Short straight between turns keeps 90-degrees turns',
+    'Large 180-degrees turn needs a front step after it',
+    'No large turn out of a diagonal',
+    'Left V-turn',
+])
+def test_path_smoother_diagonals_fast(interface, sharp, smooth):
+    """
+    Test correct path smoothing with the fast diagonals language.
+    """
+    assert smooth == smooth_path(interface, sharp, 'PATH_DIAGONALS_FAST')
+
+
+@pytest.mark.parametrize('sharp,steps', [
+    ('BFFFS', [('START', 1), ('FRONT', 3), ('STOP', 1)]),
+    ('FFLFF', [('FRONT', 2), ('LEFT_90', 1), ('FRONT', 2)]),
+    ('FLRLRLF', [('FRONT', 1), ('LEFT_TO_45', 1), ('DIAGONAL', 3),
+                 ('LEFT_FROM_45', 1), ('FRONT', 1)]),
+    ('F' * 300, [('FRONT', 255), ('FRONT', 45)]),
+], ids=[
+    'Front run',
+    'Front runs around a turn',
+    'Diagonal run',
+    'Count overflow',
+])
+def test_path_smoother_run_length(interface, sharp, steps):
+    """
+    Consecutive straight movements are packed in a single step.
+    """
+    assert steps == smooth_steps(interface, sharp, 'PATH_DIAGONALS')
+
+
+def test_path_smoother_too_long(interface):
+    """
+    Paths which do not fit in the destination are reported.
+    """
+    ffi, lib = interface
+    result = ffi.new('struct smooth_step destination[3]')
+    assert lib.make_smooth_path(b'FF', result, 3, lib.PATH_SAFE)
+    assert not lib.make_smooth_path(b'FLFF', result, 3, lib.PATH_SAFE)